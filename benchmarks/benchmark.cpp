@@ -0,0 +1,339 @@
+#include <benchmark/benchmark.h>
+#include "fg/FrameGraph.hpp"
+#include "fg/StaticPipeline.hpp"
+#include "fg/CompileCache.hpp"
+#include <vector>
+#include <span>
+#include <random>
+#include <sstream>
+#include <cstdlib>
+#include <new>
+
+// Allocation counting, reported per phase (as "allocs" counter).
+static std::size_t g_numAllocations{0};
+
+void *operator new(std::size_t size) {
+  ++g_numAllocations;
+  if (auto *ptr = std::malloc(size); ptr) return ptr;
+  throw std::bad_alloc{};
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+struct DummyResource {
+  struct Desc {
+    uint32_t size;
+  };
+
+  // Observable, otherwise inlined calls (of FrameGraphStaticPipeline) would be
+  // optimized away.
+  void create(const Desc &desc, void *) { benchmark::DoNotOptimize(desc); }
+  void destroy(const Desc &desc, void *) { benchmark::DoNotOptimize(desc); }
+};
+
+namespace {
+
+enum class Shape {
+  // Each pass consumes the outputs of its predecessor.
+  Chain,
+  // One producer, consumers of its outputs, one pass that gathers them.
+  FanOut,
+  // G-buffer, shadows, lighting and post-process chain (repeated).
+  Deferred,
+  // Each pass reads a few random outputs of the preceding passes.
+  Random,
+};
+
+struct PassData {};
+const auto kNoop = [](const PassData &, FrameGraphPassResources &, void *) {};
+
+// Appends resources written by the pass to outputs. Callers keep their
+// vectors between frames, so "allocs" are the ones of FrameGraph only.
+void addPass(FrameGraph &fg, std::span<const FrameGraphResource> inputs,
+             int32_t numOutputs, std::vector<FrameGraphResource> &outputs,
+             bool sideEffect = false) {
+  fg.addCallbackPass<PassData>(
+    "Pass",
+    [&](FrameGraph::Builder &builder, PassData &) {
+      for (const auto id : inputs)
+        builder.read(id);
+      for (auto i = 0; i < numOutputs; ++i) {
+        outputs.emplace_back(builder.write(
+          builder.create<DummyResource>("Resource", {uint32_t(i)})));
+      }
+      if (sideEffect) builder.setSideEffect();
+    },
+    kNoop);
+}
+
+void buildChain(FrameGraph &fg, int32_t numPasses) {
+  constexpr auto kResourcesPerPass = 4;
+  static std::vector<FrameGraphResource> inputs, outputs;
+  inputs.clear();
+  for (auto i = 0; i < numPasses; ++i) {
+    const auto isLast = i == numPasses - 1;
+    outputs.clear();
+    addPass(fg, inputs, kResourcesPerPass, outputs, isLast);
+    std::swap(inputs, outputs);
+  }
+}
+void buildFanOut(FrameGraph &fg, int32_t numPasses) {
+  const auto numConsumers = std::max(numPasses - 2, 1);
+  static std::vector<FrameGraphResource> produced, gathered;
+  produced.clear();
+  gathered.clear();
+  addPass(fg, {}, numConsumers, produced);
+  for (const auto &id : produced)
+    addPass(fg, {&id, 1}, 1, gathered);
+  addPass(fg, gathered, 0, produced, true); // No outputs.
+}
+void buildDeferred(FrameGraph &fg, int32_t numPasses) {
+  constexpr auto kNumShadowCascades = 4;
+  constexpr auto kNumPostProcessPasses = 6;
+  constexpr auto kPassesPerView =
+    1 + kNumShadowCascades + 1 + kNumPostProcessPasses;
+  static std::vector<FrameGraphResource> inputs, scene, outputs;
+  for (auto i = 0; i < std::max(numPasses / kPassesPerView, 1); ++i) {
+    inputs.clear();
+    addPass(fg, {}, 5, inputs); // G-buffer + depth.
+    const auto depth = inputs.back();
+    for (auto j = 0; j < kNumShadowCascades; ++j)
+      addPass(fg, {}, 1, inputs);
+    scene.clear();
+    addPass(fg, inputs, 1, scene); // Lighting.
+    for (auto j = 0; j < kNumPostProcessPasses; ++j) {
+      // Post-process passes sample the depth buffer as well.
+      scene.emplace_back(depth);
+      outputs.clear();
+      addPass(fg, scene, 1, outputs, j == kNumPostProcessPasses - 1);
+      std::swap(scene, outputs);
+    }
+  }
+}
+void buildRandom(FrameGraph &fg, int32_t numPasses) {
+  constexpr auto kMaxInputs = 4;
+  std::mt19937 rng{uint32_t(numPasses)}; // Deterministic per size.
+  static std::vector<FrameGraphResource> available, inputs;
+  available.clear();
+  for (auto i = 0; i < numPasses; ++i) {
+    inputs.clear();
+    if (!available.empty()) {
+      std::uniform_int_distribution<std::size_t> pick{0, available.size() - 1};
+      const auto numInputs = std::uniform_int_distribution{1, kMaxInputs}(rng);
+      for (auto j = 0; j < numInputs; ++j)
+        inputs.emplace_back(available[pick(rng)]);
+    }
+    const auto numOutputs = std::uniform_int_distribution{1, 2}(rng);
+    addPass(fg, inputs, numOutputs, available,
+            i % 16 == 15 || i == numPasses - 1);
+  }
+}
+
+template <Shape S> void build(FrameGraph &fg, int32_t numPasses) {
+  switch (S) {
+  case Shape::Chain:
+    buildChain(fg, numPasses);
+    break;
+  case Shape::FanOut:
+    buildFanOut(fg, numPasses);
+    break;
+  case Shape::Deferred:
+    buildDeferred(fg, numPasses);
+    break;
+  case Shape::Random:
+    buildRandom(fg, numPasses);
+    break;
+  }
+}
+
+void reportAllocations(benchmark::State &state, std::size_t numAllocations) {
+  state.counters["allocs"] = benchmark::Counter(
+    double(numAllocations), benchmark::Counter::kAvgIterations);
+}
+
+} // namespace
+
+// Declaration of passes (addCallbackPass), on a FrameGraph reused between
+// frames.
+template <Shape S> static void BM_Setup(benchmark::State &state) {
+  const auto numPasses = static_cast<int32_t>(state.range(0));
+
+  FrameGraph fg;
+  build<S>(fg, numPasses);
+  fg.reset();
+
+  std::size_t numAllocations{0};
+  for (auto _ : state) {
+    const auto first = g_numAllocations;
+    build<S>(fg, numPasses);
+    numAllocations += g_numAllocations - first;
+
+    state.PauseTiming();
+    fg.reset();
+    state.ResumeTiming();
+  }
+  reportAllocations(state, numAllocations);
+  state.SetComplexityN(numPasses);
+}
+template <Shape S, FrameGraph::Schedule Order>
+static void BM_Compile(benchmark::State &state) {
+  const auto numPasses = static_cast<int32_t>(state.range(0));
+
+  FrameGraph fg;
+  fg.setSchedule(Order);
+  build<S>(fg, numPasses);
+  fg.compile();
+
+  std::size_t numAllocations{0};
+  for (auto _ : state) {
+    const auto first = g_numAllocations;
+    fg.compile();
+    numAllocations += g_numAllocations - first;
+  }
+  reportAllocations(state, numAllocations);
+  state.SetComplexityN(numPasses);
+}
+// compile() with FrameGraphCompileCache of a graph declared each frame, the
+// cache holds it (Hit) or is cleared beforehand.
+template <Shape S, bool Hit>
+static void BM_CompileCache(benchmark::State &state) {
+  const auto numPasses = static_cast<int32_t>(state.range(0));
+
+  FrameGraphCompileCache cache;
+  FrameGraph fg;
+  fg.setCompileCache(&cache);
+  build<S>(fg, numPasses);
+  fg.compile();
+
+  std::size_t numAllocations{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    fg.reset();
+    build<S>(fg, numPasses);
+    if (!Hit) cache.clear();
+    state.ResumeTiming();
+
+    const auto first = g_numAllocations;
+    fg.compile();
+    numAllocations += g_numAllocations - first;
+  }
+  reportAllocations(state, numAllocations);
+  state.SetComplexityN(numPasses);
+}
+template <Shape S> static void BM_Execute(benchmark::State &state) {
+  const auto numPasses = static_cast<int32_t>(state.range(0));
+
+  FrameGraph fg;
+  build<S>(fg, numPasses);
+  fg.compile();
+
+  std::size_t numAllocations{0};
+  for (auto _ : state) {
+    const auto first = g_numAllocations;
+    fg.execute();
+    numAllocations += g_numAllocations - first;
+  }
+  reportAllocations(state, numAllocations);
+  state.SetComplexityN(numPasses);
+}
+template <Shape S> static void BM_Graphviz(benchmark::State &state) {
+  const auto numPasses = static_cast<int32_t>(state.range(0));
+
+  FrameGraph fg;
+  build<S>(fg, numPasses);
+  fg.compile();
+
+  std::ostringstream os;
+  std::size_t numAllocations{0};
+  for (auto _ : state) {
+    os.str({});
+    const auto first = g_numAllocations;
+    os << fg;
+    numAllocations += g_numAllocations - first;
+  }
+  reportAllocations(state, numAllocations);
+  state.SetComplexityN(numPasses);
+}
+
+// A chain of passes (the last one has a side-effect), each frame.
+constexpr auto kNumFixedPasses = 16;
+
+template <int32_t I>
+using ChainResource =
+  FrameGraphStaticTransient<std::integral_constant<int32_t, I>, DummyResource>;
+template <int32_t I> struct ChainPass {
+  using Reads = std::tuple<ChainResource<I - 1>>;
+  using Writes = std::tuple<ChainResource<I>>;
+  static constexpr bool kSideEffect{I == kNumFixedPasses - 1};
+
+  void operator()(const DummyResource &input, DummyResource &output,
+                  void *) const {
+    benchmark::DoNotOptimize(input);
+    benchmark::DoNotOptimize(output);
+  }
+};
+template <> struct ChainPass<0> {
+  using Reads = std::tuple<>;
+  using Writes = std::tuple<ChainResource<0>>;
+
+  void operator()(DummyResource &output, void *) const {
+    benchmark::DoNotOptimize(output);
+  }
+};
+template <int32_t... I>
+auto makeChainPipeline(std::integer_sequence<int32_t, I...>)
+  -> FrameGraphStaticPipeline<ChainPass<I>...>;
+
+template <bool Static> static void BM_FixedPipeline(benchmark::State &state) {
+  if constexpr (Static) {
+    decltype(makeChainPipeline(
+      std::make_integer_sequence<int32_t, kNumFixedPasses>{})) pipeline;
+    for (auto _ : state) {
+      pipeline.execute();
+      benchmark::ClobberMemory();
+    }
+  } else {
+    FrameGraph fg;
+    std::vector<FrameGraphResource> inputs, outputs;
+    for (auto _ : state) {
+      inputs.clear();
+      for (auto i = 0; i < kNumFixedPasses; ++i) {
+        outputs.clear();
+        addPass(fg, inputs, 1, outputs, i == kNumFixedPasses - 1);
+        std::swap(inputs, outputs);
+      }
+      fg.compile();
+      fg.execute();
+      fg.reset();
+    }
+  }
+}
+
+// Template arguments of a phase (shape, then schedule for BM_Compile, or a hit
+// for BM_CompileCache).
+#define FG_BENCHMARK(...)                                                      \
+  BENCHMARK_TEMPLATE(__VA_ARGS__)                                              \
+    ->RangeMultiplier(10)                                                      \
+    ->Range(100, 100'000)                                                      \
+    ->Unit(benchmark::kMicrosecond)                                            \
+    ->Complexity()
+
+#define FG_BENCHMARK_SHAPE(shape)                                              \
+  FG_BENCHMARK(BM_Setup, shape);                                               \
+  FG_BENCHMARK(BM_Compile, shape, FrameGraph::Schedule::DeclarationOrder);     \
+  FG_BENCHMARK(BM_Compile, shape, FrameGraph::Schedule::MinimizeMemory);       \
+  FG_BENCHMARK(BM_Compile, shape, FrameGraph::Schedule::MaximizeDistance);     \
+  FG_BENCHMARK(BM_CompileCache, shape, false);                                 \
+  FG_BENCHMARK(BM_CompileCache, shape, true);                                  \
+  FG_BENCHMARK(BM_Execute, shape);                                             \
+  FG_BENCHMARK(BM_Graphviz, shape)
+
+FG_BENCHMARK_SHAPE(Shape::Chain);
+FG_BENCHMARK_SHAPE(Shape::FanOut);
+FG_BENCHMARK_SHAPE(Shape::Deferred);
+FG_BENCHMARK_SHAPE(Shape::Random);
+
+BENCHMARK_TEMPLATE(BM_FixedPipeline, false);
+BENCHMARK_TEMPLATE(BM_FixedPipeline, true);
+
+BENCHMARK_MAIN();
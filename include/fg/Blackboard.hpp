@@ -1,18 +1,23 @@
 #pragma once
 
-#include <typeindex>
-#include <any>
-#include <unordered_map>
-
+#include "fg/LinearAllocator.hpp"
+#include <vector>
+#include <cstdint>
+
+/**
+ * Storage for data shared between passes, at most one instance per type.
+ * Each type gets a dense index (on first use), entries live in an arena, so
+ * a lookup is an indexed load and clear() keeps the memory for the next frame.
+ */
 class FrameGraphBlackboard {
 public:
-  FrameGraphBlackboard() = default;
-  FrameGraphBlackboard(const FrameGraphBlackboard &) = default;
+  FrameGraphBlackboard();
+  FrameGraphBlackboard(const FrameGraphBlackboard &);
   FrameGraphBlackboard(FrameGraphBlackboard &&) noexcept = default;
-  ~FrameGraphBlackboard() = default;
+  ~FrameGraphBlackboard();
 
-  FrameGraphBlackboard &operator=(const FrameGraphBlackboard &) = default;
-  FrameGraphBlackboard &operator=(FrameGraphBlackboard &&) noexcept = default;
+  FrameGraphBlackboard &operator=(const FrameGraphBlackboard &);
+  FrameGraphBlackboard &operator=(FrameGraphBlackboard &&) noexcept;
 
   template <typename T, typename... Args> T &add(Args &&...args);
 
@@ -24,8 +29,29 @@ public:
 
   template <typename T> [[nodiscard]] bool has() const;
 
+  /** Removes all entries, keeps the memory. */
+  void clear();
+
+private:
+  [[nodiscard]] static uint32_t _nextTypeIndex();
+  template <typename T> [[nodiscard]] static uint32_t _getTypeIndex();
+
+  void _copyFrom(const FrameGraphBlackboard &);
+
 private:
-  std::unordered_map<std::type_index, std::any> m_storage;
+  LinearAllocator m_arena;
+
+  struct Operations {
+    void *(*copy)(const void *, LinearAllocator &);
+    void (*destroy)(void *);
+  };
+  template <typename T> static const Operations s_operations;
+
+  struct Entry {
+    void *data{nullptr};
+    const Operations *operations{nullptr};
+  };
+  std::vector<Entry> m_entries; // At a type index.
 };
 
 #include "fg/Blackboard.inl"
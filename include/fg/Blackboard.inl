@@ -1,18 +1,52 @@
+#include <atomic>
 #include <cassert>
 
+inline FrameGraphBlackboard::FrameGraphBlackboard() : m_arena{1024} {}
+inline FrameGraphBlackboard::FrameGraphBlackboard(
+  const FrameGraphBlackboard &other)
+    : FrameGraphBlackboard{} {
+  _copyFrom(other);
+}
+inline FrameGraphBlackboard::~FrameGraphBlackboard() { clear(); }
+
+inline FrameGraphBlackboard &
+FrameGraphBlackboard::operator=(const FrameGraphBlackboard &rhs) {
+  if (this != &rhs) {
+    clear();
+    _copyFrom(rhs);
+  }
+  return *this;
+}
+inline FrameGraphBlackboard &
+FrameGraphBlackboard::operator=(FrameGraphBlackboard &&rhs) noexcept {
+  if (this != &rhs) {
+    clear();
+    m_arena = std::move(rhs.m_arena);
+    m_entries = std::move(rhs.m_entries);
+    rhs.m_entries.clear();
+  }
+  return *this;
+}
+
 template <typename T, typename... Args>
 inline T &FrameGraphBlackboard::add(Args &&...args) {
   assert(!has<T>());
-  return m_storage[typeid(T)].emplace<T>(T{std::forward<Args>(args)...});
+  const auto index = _getTypeIndex<T>();
+  if (index >= m_entries.size()) m_entries.resize(index + 1);
+  auto *data = m_arena.make<T>(std::forward<Args>(args)...);
+  m_entries[index] = {data, &s_operations<T>};
+  return *data;
 }
 
 template <typename T> const T &FrameGraphBlackboard::get() const {
   assert(has<T>());
-  return std::any_cast<const T &>(m_storage.at(typeid(T)));
+  return *static_cast<const T *>(m_entries[_getTypeIndex<T>()].data);
 }
 template <typename T> const T *FrameGraphBlackboard::try_get() const {
-  auto it = m_storage.find(typeid(T));
-  return it != m_storage.cend() ? std::any_cast<const T>(&it->second) : nullptr;
+  const auto index = _getTypeIndex<T>();
+  return index < m_entries.size()
+           ? static_cast<const T *>(m_entries[index].data)
+           : nullptr;
 }
 
 template <typename T> inline T &FrameGraphBlackboard::get() {
@@ -25,8 +59,46 @@ template <typename T> inline T *FrameGraphBlackboard::try_get() {
 }
 
 template <typename T> inline bool FrameGraphBlackboard::has() const {
-  if constexpr (__cplusplus >= 202002L)
-    return m_storage.contains(typeid(T));
-  else
-    return m_storage.find(typeid(T)) != m_storage.cend();
+  return try_get<T>() != nullptr;
+}
+
+inline void FrameGraphBlackboard::clear() {
+  for (auto &entry : m_entries) {
+    if (entry.data) entry.operations->destroy(entry.data);
+    entry = {};
+  }
+  m_arena.reset();
 }
+
+//
+// (private):
+//
+
+inline uint32_t FrameGraphBlackboard::_nextTypeIndex() {
+  static std::atomic<uint32_t> s_counter{0};
+  return s_counter.fetch_add(1, std::memory_order_relaxed);
+}
+template <typename T> inline uint32_t FrameGraphBlackboard::_getTypeIndex() {
+  static const auto s_index = _nextTypeIndex();
+  return s_index;
+}
+
+inline void FrameGraphBlackboard::_copyFrom(const FrameGraphBlackboard &other) {
+  m_entries.resize(other.m_entries.size());
+  for (std::size_t i{0}; i < other.m_entries.size(); ++i) {
+    const auto &entry = other.m_entries[i];
+    if (entry.data) {
+      m_entries[i] = {entry.operations->copy(entry.data, m_arena),
+                      entry.operations};
+    }
+  }
+}
+
+template <typename T>
+inline const FrameGraphBlackboard::Operations
+  FrameGraphBlackboard::s_operations{
+    [](const void *data, LinearAllocator &arena) -> void * {
+      return arena.make<T>(*static_cast<const T *>(data));
+    },
+    [](void *data) { static_cast<T *>(data)->~T(); },
+  };
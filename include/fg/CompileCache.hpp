@@ -0,0 +1,56 @@
+#pragma once
+
+#include "fg/FrameGraph.hpp"
+
+/**
+ * Stores results of FrameGraph::compile(), keyed by the declarations of a
+ * graph (passes, access declarations and resources, with their memory
+ * requirements) and settings of compile(). Descriptors are a part of the key
+ * only through memory requirements (nothing else in the results depends on
+ * them).
+ * Intended to outlive FrameGraph, graphs that don't change between frames
+ * skip compilation, only its results are copied.
+ */
+class FrameGraphCompileCache {
+  friend class FrameGraph;
+
+public:
+  /** @param capacity Max number of distinct graphs, least recently used one is
+   * evicted first. */
+  explicit FrameGraphCompileCache(uint32_t capacity = 4);
+  FrameGraphCompileCache(const FrameGraphCompileCache &) = delete;
+  FrameGraphCompileCache(FrameGraphCompileCache &&) noexcept = default;
+  ~FrameGraphCompileCache() = default;
+
+  FrameGraphCompileCache &operator=(const FrameGraphCompileCache &) = delete;
+  FrameGraphCompileCache &
+  operator=(FrameGraphCompileCache &&) noexcept = default;
+
+  [[nodiscard]] auto getNumHits() const { return m_numHits; }
+  [[nodiscard]] auto getNumMisses() const { return m_numMisses; }
+
+  void clear();
+
+private:
+  using Key = FrameGraph::CompileKey;
+  using Settings = FrameGraph::CompileSettings;
+  using CompiledGraph = FrameGraph::CompiledGraph;
+
+  [[nodiscard]] const CompiledGraph *_find(const Key &, const Settings &);
+  /** @return Unused (or least recently used) slot, ready to be filled. */
+  [[nodiscard]] CompiledGraph &_insert(const Key &, const Settings &);
+
+private:
+  const uint32_t m_capacity;
+  struct Entry {
+    Key key;
+    Settings settings;
+    uint64_t lastUsed{0};
+    CompiledGraph graph;
+  };
+  std::vector<Entry> m_entries;
+  uint64_t m_numCompilations{0};
+
+  uint32_t m_numHits{0};
+  uint32_t m_numMisses{0};
+};
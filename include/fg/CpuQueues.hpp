@@ -0,0 +1,52 @@
+#pragma once
+
+#include "fg/QueueSystem.hpp"
+#include <array>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+// Emulates queues on CPU threads (one per queue), so sync points can be tested
+// without a GPU. A pass records commands to the context of its queue
+// (CommandList), submit() executes them.
+class FrameGraphCpuQueues final : public FrameGraphQueueSystem {
+public:
+  FrameGraphCpuQueues() = default;
+
+  using Command = std::function<void()>;
+  class CommandList {
+    friend class FrameGraphCpuQueues;
+
+  public:
+    void record(Command command) { m_commands.push_back(std::move(command)); }
+
+  private:
+    std::vector<Command> m_commands;
+  };
+
+  [[nodiscard]] void *getContext(FrameGraphQueue) override;
+  void signal(FrameGraphQueue, uint32_t value) override;
+  void wait(FrameGraphQueue, FrameGraphQueue signaled,
+            uint32_t value) override;
+
+  /**
+   * Executes recorded commands (queues run concurrently), blocks until all
+   * of them are done. Clears command lists and resets timelines.
+   */
+  void submit();
+
+  /** @return Number of waits executed by the last submit(). */
+  [[nodiscard]] auto getNumWaits() const { return m_numWaits; }
+
+private:
+  void _run(uint32_t queueIndex);
+
+private:
+  std::array<CommandList, kNumQueues> m_commandLists;
+
+  std::mutex m_mutex;
+  std::condition_variable m_signaled;
+  std::array<uint32_t, kNumQueues> m_timelines{}; // Guarded by m_mutex.
+  uint32_t m_numWaits{0};                         // Guarded by m_mutex.
+};
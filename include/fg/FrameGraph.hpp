@@ -3,12 +3,34 @@
 #include "fg/PassNode.hpp"
 #include "fg/ResourceNode.hpp"
 #include "fg/ResourceEntry.hpp"
+#include "fg/LinearAllocator.hpp"
+#include "fg/NameTable.hpp"
+#include "fg/QueueSystem.hpp"
+#include "fg/Hash.hpp"
+#include <optional>
+#include <map>
+#include <set>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+class FrameGraphCompileCache;
+class FrameGraphJobSystem;
+class FrameGraphInstrumentation;
 
 class FrameGraph {
   friend class FrameGraphPassResources;
+  friend class FrameGraphCompileCache;
 
 public:
-  FrameGraph() = default;
+  FrameGraph();
+  /**
+   * @param arena Per-frame memory for passes and resources, must outlive
+   * FrameGraph.
+   * @remark Owner of the arena is responsible for LinearAllocator::reset()
+   * (after FrameGraph::reset()).
+   */
+  explicit FrameGraph(LinearAllocator &arena);
   FrameGraph(const FrameGraph &) = delete;
   FrameGraph(FrameGraph &&) noexcept = delete;
 
@@ -49,6 +71,14 @@ public:
       m_passNode.m_hasSideEffect = true;
       return *this;
     }
+    /**
+     * Selects a queue that executes this pass (Graphics by default).
+     * @see FrameGraph::getSyncPoints
+     */
+    Builder &setQueue(FrameGraphQueue queue) {
+      m_passNode.m_queue = queue;
+      return *this;
+    }
 
   private:
     Builder(FrameGraph &fg, PassNode &node)
@@ -60,6 +90,15 @@ public:
   };
 
   void reserve(uint32_t numPasses, uint32_t numResources);
+  /**
+   * Destroys all passes and resources, but keeps the allocated memory, so the
+   * graph can be rebuilt (e.g. in the next frame) without allocations.
+   * Interned names are kept as well, unless most of them went unused (e.g.
+   * generated per frame).
+   */
+  void reset();
+  /** @return Number of distinct names of passes and resources (interned). */
+  [[nodiscard]] auto getNumNames() const { return m_names.size(); }
 
   struct NoData {};
   /**
@@ -67,6 +106,7 @@ public:
    * immediately, declare operations here.
    * @param exec Execution of this lambda is deferred until execute() phase
    * (must capture by value due to this).
+   * @note The pass (Data and exec) is stored in the per-frame arena.
    */
   template <typename Data = NoData, typename Setup, typename Execute>
   const Data &addCallbackPass(const std::string_view name, Setup &&setup,
@@ -84,18 +124,272 @@ public:
   /** @return True if the given resource is valid for read/write operation. */
   [[nodiscard]] bool isValid(FrameGraphResource id) const;
 
+  class Recorder;
+  /**
+   * @return Recorder that declares passes on another thread (one per thread),
+   * valid until reset().
+   * @see mergeRecorders
+   */
+  [[nodiscard]] Recorder &createRecorder();
+  /**
+   * Moves passes and resources of recorders (created since the last merge)
+   * into this graph, in the order of their creation. Handles given by the
+   * recorders remain valid (also in execution callbacks).
+   * @remark Invoked by compile(), recording has to be done by then.
+   */
+  void mergeRecorders();
+
   /** Culls unreferenced resources and passes. */
   void compile();
+  enum class Schedule : uint8_t {
+    DeclarationOrder, // Passes are executed in the order of addCallbackPass.
+    MinimizeMemory,   // Keeps the size (then count) of live transients low.
+    MaximizeDistance, // Delays passes after their dependencies, for overlap.
+  };
+  /**
+   * Selects the order of passes determined by compile(), within dependencies
+   * of their accesses. Passes with side-effect keep their relative order.
+   */
+  void setSchedule(Schedule);
+  /** @return Ids of passes in the order of execution, valid after compile(). */
+  [[nodiscard]] const auto &getExecutionOrder() const {
+    return m_executionOrder;
+  }
+
+  /**
+   * compile() reuses results of a structurally identical graph compiled before
+   * (if any) from the given cache, nullptr disables it.
+   * @remark Declarations are keyed as they're made, so the cache has to be set
+   * before them (it's kept by reset()), and outlive compile().
+   */
+  void setCompileCache(FrameGraphCompileCache *);
   /** Invokes execution callbacks. */
   void execute(void *context = nullptr, void *allocator = nullptr);
+  /**
+   * Invokes execution callbacks on workers of the given job system, passes
+   * that don't depend on each other (through resources, or heap memory of
+   * aliased transients) run concurrently.
+   * Blocks until all passes are done.
+   * @param contexts Array of FrameGraphJobSystem::getNumWorkers() contexts
+   * (or nullptr), a pass gets the one of the worker that runs it.
+   * @remark Calls to resource create/destroy (allocator) are serialized.
+   */
+  void execute(FrameGraphJobSystem &, void *const *contexts = nullptr,
+               void *allocator = nullptr);
+  /**
+   * Invokes execution callbacks in the order of execution, each with the
+   * context of its queue. Signals and waits of sync points are issued around
+   * passes.
+   */
+  void execute(FrameGraphQueueSystem &, void *allocator = nullptr);
+
+  struct TransientMemoryStats {
+    // Sum of sizes of all aliasable transients (without aliasing).
+    uint64_t unaliasedSize{0};
+    // Max size of aliasable transients alive at the same time (lower bound).
+    uint64_t peakLiveSize{0};
+    // Required size of a heap for aliasable transients (with aliasing).
+    uint64_t heapSize{0};
+  };
+  /**
+   * @return Memory usage of transients that provide memoryRequirements,
+   * valid after compile().
+   */
+  [[nodiscard]] const auto &getTransientMemoryStats() const {
+    return m_transientMemoryStats;
+  }
+
+  /**
+   * Transients are recycled through the given pool (if poolable) instead of
+   * being created/destroyed each frame. nullptr disables pooling.
+   * @remark The pool has to outlive execute().
+   */
+  void setResourcePool(FrameGraphResourcePool *);
+
+  // Read/write declaration (with flags other than kFlagsIgnored) of a pass.
+  struct Transition {
+    enum class Access : uint8_t { Read, Write };
+
+    ResourceEntry *entry;
+    uint32_t flags;
+    Access access;
+  };
+  /**
+   * Receives all transitions of a pass at once (reads first, then writes),
+   * right before its execution. The parallel execute() may append reads
+   * elided in the serial order.
+   * @remark Invoked concurrently by the parallel execute().
+   */
+  using FlushBarriers = void (*)(const Transition *, uint32_t count,
+                                 void *context);
+  /**
+   * Replaces per-resource T::preRead/T::preWrite with a single call per pass,
+   * nullptr restores them.
+   */
+  void setBarrierHandler(FlushBarriers);
+
+  /**
+   * @return True if a resource left in the state of the previous transition
+   * can be accessed as in the next one, without a barrier.
+   */
+  using IsStateCompatible = bool (*)(const Transition &previous,
+                                     const Transition &next);
+  /** Consecutive reads with the same flags. */
+  [[nodiscard]] static bool isSameRead(const Transition &previous,
+                                       const Transition &next);
+  /**
+   * Enables elision of redundant transitions (tracked per resource in the
+   * execution order), nullptr disables it.
+   * @remark Elided transitions don't reach preRead/preWrite nor the barrier
+   * handler, so those should not rely on being called for every access.
+   */
+  void setTransitionElision(IsStateCompatible = isSameRead);
+
+  struct TransitionStats {
+    uint32_t numTransitions{0}; // Declared, with flags other than ignored.
+    uint32_t numElided{0};      // In the serial execute().
+    // Begun (T::beginTransition) after an earlier pass.
+    uint32_t numSplit{0};
+  };
+  /** @return Valid after compile(). */
+  [[nodiscard]] const auto &getTransitionStats() const {
+    return m_transitionStats;
+  }
+
+  /**
+   * @return True if a pass that reads (as an input attachment) what the
+   * previous one writes can be its subpass.
+   */
+  using CanMerge = bool (*)(const Transition &write, const Transition &read);
+  /**
+   * Enables merging of consecutive passes linked by a write -> read of the
+   * same resource (both with flags), nullptr disables it.
+   * @see FrameGraphPassResources::getSubpassIndex
+   */
+  void setPassMerging(CanMerge);
+
+  struct MergeGroup {
+    uint32_t first; // Position in getExecutionOrder().
+    uint32_t count; // At least 2.
+  };
+  /** @return Valid after compile(). */
+  [[nodiscard]] const auto &getMergeGroups() const { return m_mergeGroups; }
+
+  /**
+   * @return Passes of the given queue in the order of execution, valid after
+   * compile().
+   */
+  [[nodiscard]] const auto &getQueueStream(FrameGraphQueue queue) const {
+    return m_queueStreams[static_cast<uint32_t>(queue)];
+  }
+  // A pass waits for a pass of another queue that it depends on.
+  struct SyncPoint {
+    uint32_t signalPassId; // Signals after its execution (or its merge group).
+    uint32_t waitPassId;   // Waits before its execution (or its merge group).
+    uint32_t value; // Position of the signaling pass in its queue stream + 1.
+  };
+  /**
+   * @return Waits between queues (in the order of execution of waiting
+   * passes), valid after compile(). Dependencies already covered by an
+   * earlier wait (also transitively, through another queue) don't get one.
+   */
+  [[nodiscard]] const auto &getSyncPoints() const { return m_syncPoints; }
+
+  /**
+   * Receives begin/end events of passes from execute(), nullptr disables it.
+   * @remark No effect without FG_ENABLE_INSTRUMENTATION.
+   */
+  void setInstrumentation(FrameGraphInstrumentation *);
 
   template <typename Writer>
   std::ostream &debugOutput(std::ostream &, Writer &&) const;
 
 private:
+  /** Flattens access declarations of passes into m_accesses (CSR). */
+  void _buildAccessLists();
+  void _cull();
+  void _computeResourcesLifetime();
+  void _buildResourceLists();
+  void _buildDependencies();
+  /** Successors of passes (CSR) from m_edges. */
+  void _buildSuccessors();
+  /** Topological sort of executable passes (DAG from _buildDependencies). */
+  void _schedule();
+  void _buildTransitions();
+  void _mergePasses();
+  /** Splits the execution order into queue streams, finds sync points. */
+  void _buildQueueStreams();
+  /**
+   * Assigns heap offsets to aliasable transients, so the ones with disjoint
+   * lifetimes share memory. A pass that reuses memory depends on the last
+   * accesses of its previous occupants.
+   */
+  void _aliasTransients();
+
+  /**
+   * Appends a declaration to m_compileKey, as it's made (a pass once it's set
+   * up). Names and execution callbacks are not a part of it.
+   */
+  void _addToCompileKey(const ResourceEntry &);
+  /** @param merged Of a recorder, otherwise a clone (see _clone()). */
+  void _addToCompileKey(const ResourceNode &, bool merged);
+  void _addToCompileKey(const PassNode &);
+  struct CompiledGraph;
+  void _storeCompiled(CompiledGraph &) const;
+  /** Counterpart of compile(), for a graph with the same key. */
+  void _restoreCompiled(const CompiledGraph &);
+
+  /** @param queues Provides contexts, otherwise the given one is used. */
+  void _executeSerial(FrameGraphQueueSystem *queues, void *context,
+                      void *allocator);
+  /**
+   * Split transitions of passes are known once their merge groups and queues
+   * are.
+   */
+  void _buildSplitTransitions();
+  /** @param parallel Issues transitions elided after unordered reads. */
+  void _executePass(const PassNode &, void *context, uint32_t workerIndex,
+                    bool parallel);
+
+  struct ParallelExecution;
+  struct PassJob {
+    ParallelExecution *execution;
+    const PassNode *pass;
+    std::atomic<uint32_t> numPendingDependencies;
+  };
+  /** Executes all passes of a merge group (PassJob::pass is the first). */
+  static void _executeJob(void *job, uint32_t workerIndex);
+  [[nodiscard]] uint32_t _getMergeGroupLeader(uint32_t passId) const {
+    return m_executionOrder[m_subpasses[passId].first];
+  }
+
+  /** Recorder of the given parent graph (storage of FrameGraph::Recorder). */
+  FrameGraph(const FrameGraph &parent, uint32_t slot);
+  /** Destroys passes and resources, keeps storage of passes (pool). */
+  void _recycleNodes();
+  void _merge(Recorder &);
+
+  [[nodiscard]] static uint32_t _getSlot(FrameGraphResource id) {
+    return static_cast<uint32_t>(id) >> kSlotShift;
+  }
+  /** @return True if a recorder got the handle from its parent graph. */
+  [[nodiscard]] bool _isForeign(FrameGraphResource id) const {
+    return m_parent && _getSlot(id) == 0;
+  }
+  [[nodiscard]] FrameGraphResource _toHandle(uint32_t nodeId) const;
+  /** @return ResourceNode id (in this graph) of the given handle. */
+  [[nodiscard]] uint32_t _resolve(FrameGraphResource id) const;
+  /**
+   * @return Id as declared by passes: ResourceNode id in the main graph, the
+   * handle itself in a recorder (might be foreign).
+   */
+  [[nodiscard]] FrameGraphResource _canonicalize(FrameGraphResource id) const {
+    return m_parent ? id : static_cast<FrameGraphResource>(_resolve(id));
+  }
+
   [[nodiscard]] PassNode &
   _createPassNode(const std::string_view name,
-                  std::unique_ptr<FrameGraphPassConcept> &&);
+                  ArenaPtr<FrameGraphPassConcept> &&);
 
   template <_VIRTUALIZABLE_CONCEPT(T)>
   [[nodiscard]] FrameGraphResource _create(const ResourceEntry::Type,
@@ -103,7 +397,7 @@ private:
                                            const typename T::Desc &, T &&);
 
   [[nodiscard]] ResourceNode &
-  _createResourceNode(const std::string_view name, uint32_t resourceId,
+  _createResourceNode(const NameTable::Name, uint32_t resourceId,
                       uint32_t version = ResourceEntry::kInitialVersion);
   /** Increments ResourceEntry version and produces a renamed handle. */
   [[nodiscard]] FrameGraphResource _clone(FrameGraphResource id);
@@ -128,10 +422,323 @@ private:
       const_cast<const FrameGraph *>(this)->_getResourceEntry(node));
   }
 
+  template <typename T> struct Slice {
+    const T *first;
+    const T *last;
+
+    [[nodiscard]] auto begin() const { return first; }
+    [[nodiscard]] auto end() const { return last; }
+    [[nodiscard]] auto size() const { return uint32_t(last - first); }
+  };
+  struct Access;
+  [[nodiscard]] Slice<Access> _getAccesses(uint32_t passId) const;
+  [[nodiscard]] Slice<Access> _getCreates(uint32_t passId) const;
+  [[nodiscard]] Slice<Access> _getReads(uint32_t passId) const;
+  [[nodiscard]] Slice<Access> _getWrites(uint32_t passId) const;
+  [[nodiscard]] Slice<uint32_t> _getReaders(uint32_t nodeId) const;
+  [[nodiscard]] Slice<uint32_t> _getSuccessors(uint32_t passId) const;
+
 private:
+  // Declared first, arenas have to outlive passes and resources.
+  std::optional<LinearAllocator> m_ownArena;
+  LinearAllocator *m_arena;
+  // Kept between frames, first m_numRecorders are in use. Arenas of recorders
+  // hold the payload of merged passes and resources as well.
+  std::vector<std::unique_ptr<Recorder>> m_recorders;
+  // Names of nodes, kept between frames (see reset()).
+  NameTable m_names;
+
   std::vector<PassNode> m_passNodes;
   std::vector<ResourceNode> m_resourceNodes;
   std::vector<ResourceEntry> m_resourceRegistry;
+
+  // Nodes from the previous frame (with empty payload), their storage is
+  // reused by _createPassNode().
+  std::vector<PassNode> m_passNodePool;
+
+  // Handles of a recorder have its slot (index + 1) in the high bits, the main
+  // graph resolves them with the node offset of the recorder.
+  static constexpr uint32_t kSlotShift{24};
+  static constexpr uint32_t kMaxRecorders{127};
+  const FrameGraph *m_parent{nullptr}; // Of a recorder.
+  uint32_t m_slot{0};
+  uint32_t m_numRecorders{0};
+  uint32_t m_numMerged{0};
+
+  // Compiled graph, in compressed sparse row layout:
+  struct Access {
+    uint32_t nodeId;  // ResourceNode.
+    uint32_t entryId; // ResourceEntry.
+    uint32_t flags;
+  };
+  struct AccessRanges {
+    // Offsets to m_accesses: [creates, reads), [reads, writes), [writes, end)
+    uint32_t creates;
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t end;
+  };
+  std::vector<Access> m_accesses;
+  std::vector<AccessRanges> m_accessRanges; // Per PassNode.
+  std::vector<uint32_t> m_producers;        // PassNode id per ResourceNode.
+  // Readers of a ResourceNode (PassNode ids) are in
+  // m_readers[m_readerOffsets[id], m_readerOffsets[id + 1]).
+  std::vector<uint32_t> m_readerOffsets;
+  std::vector<uint32_t> m_readers;
+  // Dependencies between executed passes (PassNode ids), successors of a pass
+  // are in m_successors[m_successorOffsets[id], m_successorOffsets[id + 1]).
+  // Includes the ones of aliased transients (not counted in m_numPredecessors).
+  std::vector<uint32_t> m_successorOffsets;
+  std::vector<uint32_t> m_successors;
+  std::vector<uint32_t> m_numPredecessors; // Per PassNode.
+
+  // Scratch memory of compile():
+  std::vector<uint32_t> m_unreferencedResources; // Culling stack.
+  std::vector<uint32_t> m_cursors;
+  std::vector<uint32_t> m_writeStamps; // PassNode id per ResourceEntry.
+  struct Edge {
+    uint32_t from;
+    uint32_t to;
+  };
+  std::vector<Edge> m_edges;
+  std::vector<uint32_t> m_edgeStamps; // Per PassNode.
+  std::vector<uint32_t> m_readyPasses; // Also roots of parallel execute().
+  std::vector<uint32_t> m_numPendingPredecessors; // Per PassNode.
+  std::vector<uint32_t> m_nextSideEffects;        // PassNode id per PassNode.
+  std::vector<uint32_t> m_remainingAccesses; // Per ResourceEntry.
+  std::vector<uint32_t> m_remainingPasses;   // Per ResourceEntry.
+  std::vector<uint32_t> m_accessStamps;      // PassNode id per ResourceEntry.
+  // Executable passes that access a resource, the ones of a ResourceEntry are
+  // in [offsets[id], offsets[id + 1]).
+  std::vector<uint32_t> m_accessingPassOffsets;
+  std::vector<uint32_t> m_accessingPasses;
+  struct ReadyPass {
+    int64_t primary;   // Cost, see _schedule().
+    int64_t secondary;
+    uint32_t passId;
+    uint32_t stamp;    // Of the evaluation.
+  };
+  std::vector<ReadyPass> m_readyHeap;
+  static constexpr uint32_t kScheduled{~0u};
+  std::vector<uint32_t> m_costStamps; // Per PassNode, kScheduled once it is.
+  // Everything that results of compile() depend on (see
+  // FrameGraphCompileCache), other than settings.
+  struct CompileKey {
+    std::vector<uint32_t> words;
+    std::size_t hash{kHashSeed};
+
+    void push(uint32_t word) {
+      words.push_back(word);
+      hash = hashWord(hash, word);
+    }
+    /** Appends object representations of the given values. */
+    template <typename T> void append(const T *values, std::size_t count) {
+      static_assert(std::has_unique_object_representations_v<T> &&
+                    sizeof(T) % sizeof(uint32_t) == 0);
+      const auto first = words.size();
+      words.resize(first + count * sizeof(T) / sizeof(uint32_t));
+      if (count > 0) std::memcpy(&words[first], values, count * sizeof(T));
+      for (auto i = first; i < words.size(); ++i)
+        hash = hashWord(hash, words[i]);
+    }
+  };
+  CompileKey m_compileKey;
+  struct CompileSettings {
+    Schedule schedule;
+    CanMerge canMerge;
+    IsStateCompatible isStateCompatible;
+
+    bool operator==(const CompileSettings &other) const {
+      return schedule == other.schedule && canMerge == other.canMerge &&
+             isStateCompatible == other.isStateCompatible;
+    }
+  };
+  static constexpr auto kNumQueues = FrameGraphQueueSystem::kNumQueues;
+  // Passes known to be done on each queue (stream position + 1).
+  using QueueClock = std::array<uint32_t, kNumQueues>;
+  struct MemoryRange {
+    uint64_t size;
+    QueueClock released; // Reusable by passes that have waited for it.
+  };
+  std::map<uint64_t, MemoryRange> m_freeHeapRanges; // Keyed by offset.
+  // Free ranges by size (then offset), for a best-fit lookup.
+  std::set<std::pair<uint64_t, uint64_t>> m_freeHeapSizes;
+
+  Schedule m_schedule{Schedule::DeclarationOrder};
+  std::vector<uint32_t> m_executionOrder;
+
+  TransientMemoryStats m_transientMemoryStats;
+
+  FrameGraphResourcePool *m_resourcePool{nullptr};
+  FrameGraphCompileCache *m_compileCache{nullptr};
+
+  FlushBarriers m_flushBarriers{nullptr};
+  IsStateCompatible m_isStateCompatible{nullptr};
+
+  // Transitions of all passes, the ones of a PassNode are in
+  // [first, first + count), followed by numUnordered transitions elided
+  // after a read in another pass. Readers are not ordered by the parallel
+  // execute(), so it issues them anyway.
+  std::vector<Transition> m_transitions;
+  struct TransitionRange {
+    uint32_t first;
+    uint32_t count;
+    uint32_t numUnordered;
+  };
+  std::vector<TransitionRange> m_transitionRanges; // Per PassNode.
+  struct ResourceState {
+    Transition transition; // Last issued.
+    uint32_t passId;
+  };
+  std::vector<ResourceState> m_resourceStates; // Per ResourceEntry.
+  std::vector<Transition> m_unorderedTransitions;
+
+  // Transitions of resources with T::beginTransition/T::endTransition. The
+  // begin half is issued after the last previous access (its merge group),
+  // the end half before the next access. Not split across queues, within a
+  // merge group, nor for the first access.
+  struct SplitTransition {
+    ResourceEntry *entry;
+    uint32_t previousFlags;
+    uint32_t nextFlags;
+    uint32_t beginPassId; // PassNode id, ~0u if not split.
+  };
+  std::vector<SplitTransition> m_splitTransitions; // Ordered by the next pass.
+  struct SplitRange {
+    uint32_t first;
+    uint32_t count;
+  };
+  std::vector<SplitRange> m_splitRanges; // Per PassNode (next).
+  // Split transitions begun after a PassNode (indices to m_splitTransitions)
+  // are in m_splitBegins[m_splitBeginOffsets[id], m_splitBeginOffsets[id + 1]).
+  std::vector<uint32_t> m_splitBeginOffsets;
+  std::vector<uint32_t> m_splitBegins;
+  struct LastAccess {
+    uint32_t passId;
+    uint32_t flags; // Of the last issued transition.
+    uint32_t nodeId; // Read by the pass, kInvalidId if it writes the entry.
+  };
+  std::vector<LastAccess> m_lastAccesses; // Per ResourceEntry.
+
+  TransitionStats m_transitionStats;
+
+  FrameGraphInstrumentation *m_instrumentation{nullptr};
+
+  CanMerge m_canMerge{nullptr};
+  std::vector<MergeGroup> m_mergeGroups;
+  struct Subpass {
+    uint32_t first; // Position of the first pass of a group (or the pass).
+    uint32_t index;
+    uint32_t count; // 1 = Not merged.
+  };
+  std::vector<Subpass> m_subpasses; // Per PassNode.
+
+  std::array<std::vector<uint32_t>, kNumQueues> m_queueStreams;
+  std::vector<SyncPoint> m_syncPoints;
+  std::vector<uint32_t> m_signalValues; // Per PassNode, 0 = no signal.
+  // Scratch memory of _buildQueueStreams() and _aliasTransients():
+  std::vector<uint32_t> m_streamPositions; // Per PassNode.
+  // Per PassNode (before it's executed), empty with a single queue.
+  std::vector<QueueClock> m_passClocks;
+  // Last predecessor on each queue (PassNode id), per PassNode.
+  std::vector<std::array<uint32_t, kNumQueues>> m_lastPredecessors;
+  std::vector<QueueClock> m_entryClocks; // Last accesses per ResourceEntry.
+  std::vector<uint32_t> m_lastNodes; // ResourceNode id per ResourceEntry.
+  struct HeapOccupant {
+    uint64_t size;
+    uint32_t entryId;
+  };
+  // Memory of released transients, keyed by offset (no overlaps).
+  std::map<uint64_t, HeapOccupant> m_heapOccupants;
+
+  // Results of compile() used afterwards (by execute() and getters), with
+  // ResourceEntry ids in place of pointers.
+  struct CompiledGraph {
+    std::vector<int32_t> refCounts; // Of PassNodes, then of ResourceNodes.
+    struct EntryState {
+      uint64_t heapOffset;
+      uint32_t producer;
+      uint32_t last;
+    };
+    std::vector<EntryState> entries;
+    // Acquires of a PassNode are in resourceLists[offsets[2 * id],
+    // offsets[2 * id + 1]), its releases follow up to offsets[2 * id + 2].
+    std::vector<uint32_t> resourceListOffsets;
+    std::vector<uint32_t> resourceLists;
+
+    std::vector<Access> accesses;
+    std::vector<AccessRanges> accessRanges;
+    std::vector<uint32_t> successorOffsets;
+    std::vector<uint32_t> successors;
+    std::vector<uint32_t> executionOrder;
+    TransientMemoryStats transientMemoryStats;
+
+    std::vector<Transition> transitions;
+    std::vector<uint32_t> transitionEntryIds;
+    std::vector<TransitionRange> transitionRanges;
+    TransitionStats transitionStats;
+    std::vector<SplitTransition> splitTransitions;
+    std::vector<uint32_t> splitEntryIds;
+    std::vector<SplitRange> splitRanges;
+    std::vector<uint32_t> splitBeginOffsets;
+    std::vector<uint32_t> splitBegins;
+
+    std::vector<MergeGroup> mergeGroups;
+    std::vector<Subpass> subpasses;
+    std::array<std::vector<uint32_t>, kNumQueues> queueStreams;
+    std::vector<SyncPoint> syncPoints;
+    std::vector<uint32_t> signalValues;
+  };
+
+  // Scratch memory of the parallel execute():
+  std::unique_ptr<PassJob[]> m_passJobs;
+  uint32_t m_numPassJobs{0};
+  // Per ResourceEntry, number of accesses left before it can be destroyed.
+  std::unique_ptr<std::atomic<uint32_t>[]> m_pendingAccesses;
+  uint32_t m_numPendingAccesses{0};
+};
+
+// Declares passes into storage of its own, so subgraphs can be built on
+// different threads at the same time. Setup callbacks get FrameGraph::Builder,
+// as with FrameGraph::addCallbackPass. Resources of the main graph (declared
+// before recording, the main graph must not change meanwhile) can be read, but
+// only the ones created or imported by the recorder can be written. Handles of
+// other recorders are valid after FrameGraph::mergeRecorders().
+class FrameGraph::Recorder final {
+  friend class FrameGraph;
+
+public:
+  Recorder() = delete;
+  Recorder(const Recorder &) = delete;
+  Recorder(Recorder &&) noexcept = delete;
+
+  Recorder &operator=(const Recorder &) = delete;
+  Recorder &operator=(Recorder &&) noexcept = delete;
+
+  /** @see FrameGraph::addCallbackPass */
+  template <typename Data = NoData, typename Setup, typename Execute>
+  const Data &addCallbackPass(const std::string_view name, Setup &&setup,
+                              Execute &&exec);
+
+  template <_VIRTUALIZABLE_CONCEPT(T)>
+  [[nodiscard]] const typename T::Desc &
+  getDescriptor(FrameGraphResource id) const;
+
+  template <_VIRTUALIZABLE_CONCEPT(T)>
+  [[nodiscard]] FrameGraphResource import(const std::string_view name,
+                                          const typename T::Desc &, T &&);
+
+  [[nodiscard]] bool isValid(FrameGraphResource id) const {
+    return m_graph.isValid(id);
+  }
+
+private:
+  Recorder(const FrameGraph &parent, uint32_t slot);
+
+private:
+  FrameGraph m_graph; // With an arena of its own.
+  // Of the first ResourceNode in the main graph, ~0u until merged.
+  uint32_t m_nodeOffset;
 };
 
 class FrameGraphPassResources {
@@ -158,13 +765,27 @@ public:
   [[nodiscard]] const typename T::Desc &
   getDescriptor(FrameGraphResource id) const;
 
+  /** @return Index of a worker that executes the pass (0 if serial). */
+  [[nodiscard]] auto getWorkerIndex() const { return m_workerIndex; }
+
+  /**
+   * @return Index of the pass in its merge group, begin a render pass at 0,
+   * end it at getNumSubpasses() - 1.
+   * @remark Passes of a group run on the same worker, one after another.
+   */
+  [[nodiscard]] uint32_t getSubpassIndex() const;
+  /** @return Number of passes in the merge group (1 = not merged). */
+  [[nodiscard]] uint32_t getNumSubpasses() const;
+
 private:
-  FrameGraphPassResources(FrameGraph &fg, const PassNode &node)
-      : m_frameGraph{fg}, m_passNode{node} {}
+  FrameGraphPassResources(FrameGraph &fg, const PassNode &node,
+                          uint32_t workerIndex)
+      : m_frameGraph{fg}, m_passNode{node}, m_workerIndex{workerIndex} {}
 
 private:
   FrameGraph &m_frameGraph;
   const PassNode &m_passNode;
+  const uint32_t m_workerIndex;
 };
 
 #include "fg/FrameGraph.inl"
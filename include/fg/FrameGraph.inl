@@ -12,13 +12,14 @@ inline const Data &FrameGraph::addCallbackPass(const std::string_view name,
   static_assert(std::is_invocable_v<Execute, const Data &,
                                     FrameGraphPassResources &, void *>,
                 "Invalid exec callback");
-  static_assert(sizeof(Execute) < 1024, "Execute captures too much");
 
-  auto *pass = new FrameGraphPass<Data, Execute>(std::forward<Execute>(exec));
+  auto *pass = m_arena->make<FrameGraphPass<Data, Execute>>(
+    std::forward<Execute>(exec));
   auto &passNode =
-    _createPassNode(name, std::unique_ptr<FrameGraphPass<Data, Execute>>(pass));
+    _createPassNode(name, ArenaPtr<FrameGraphPassConcept>{pass});
   Builder builder{*this, passNode};
   std::invoke(setup, builder, pass->data);
+  _addToCompileKey(passNode);
   return pass->data;
 }
 
@@ -58,9 +59,34 @@ inline FrameGraphResource
 FrameGraph::_create(const ResourceEntry::Type type, const std::string_view name,
                     const typename T::Desc &desc, T &&resource) {
   const auto resourceId = static_cast<uint32_t>(m_resourceRegistry.size());
-  m_resourceRegistry.emplace_back(
-    ResourceEntry{type, resourceId, desc, std::forward<T>(resource)});
-  return _createResourceNode(name, resourceId).getId();
+  _addToCompileKey(m_resourceRegistry.emplace_back(ResourceEntry{
+    type, resourceId, desc, std::forward<T>(resource), *m_arena}));
+  const auto &node = _createResourceNode(m_names.intern(name), resourceId);
+  return _toHandle(node.getId());
+}
+
+//
+// FrameGraph::Recorder class:
+//
+
+template <typename Data, typename Setup, typename Execute>
+inline const Data &FrameGraph::Recorder::addCallbackPass(
+  const std::string_view name, Setup &&setup, Execute &&exec) {
+  return m_graph.addCallbackPass<Data>(name, std::forward<Setup>(setup),
+                                       std::forward<Execute>(exec));
+}
+
+template <_VIRTUALIZABLE_CONCEPT_IMPL(T)>
+inline const typename T::Desc &
+FrameGraph::Recorder::getDescriptor(FrameGraphResource id) const {
+  return m_graph.getDescriptor<T>(id);
+}
+
+template <_VIRTUALIZABLE_CONCEPT_IMPL(T)>
+inline FrameGraphResource
+FrameGraph::Recorder::import(const std::string_view name,
+                             const typename T::Desc &desc, T &&resource) {
+  return m_graph.import<T>(name, desc, std::forward<T>(resource));
 }
 
 //
@@ -73,23 +99,34 @@ FrameGraph::Builder::create(const std::string_view name,
                             const typename T::Desc &desc) {
   const auto id =
     m_frameGraph._create<T>(ResourceEntry::Type::Transient, name, desc, T{});
-  return m_passNode.m_creates.emplace_back(id);
+  return m_passNode._create(id);
 }
 
 //
 // FrameGraphPassResources class:
 //
 
+inline uint32_t FrameGraphPassResources::getSubpassIndex() const {
+  return m_frameGraph.m_subpasses[m_passNode.getId()].index;
+}
+inline uint32_t FrameGraphPassResources::getNumSubpasses() const {
+  return m_frameGraph.m_subpasses[m_passNode.getId()].count;
+}
+
 template <_VIRTUALIZABLE_CONCEPT_IMPL(T)>
 inline T &FrameGraphPassResources::get(FrameGraphResource id) {
-  assert(m_passNode.reads(id) || m_passNode.creates(id) ||
-         m_passNode.writes(id));
-  return m_frameGraph._getResourceEntry(id).get<T>();
+  const auto nodeId =
+    static_cast<FrameGraphResource>(m_frameGraph._resolve(id));
+  assert(m_passNode.reads(nodeId) || m_passNode.creates(nodeId) ||
+         m_passNode.writes(nodeId));
+  return m_frameGraph._getResourceEntry(nodeId).get<T>();
 }
 template <_VIRTUALIZABLE_CONCEPT_IMPL(T)>
 inline const typename T::Desc &
 FrameGraphPassResources::getDescriptor(FrameGraphResource id) const {
-  assert(m_passNode.reads(id) || m_passNode.creates(id) ||
-         m_passNode.writes(id));
-  return m_frameGraph.getDescriptor<T>(id);
+  const auto nodeId =
+    static_cast<FrameGraphResource>(m_frameGraph._resolve(id));
+  assert(m_passNode.reads(nodeId) || m_passNode.creates(nodeId) ||
+         m_passNode.writes(nodeId));
+  return m_frameGraph.getDescriptor<T>(nodeId);
 }
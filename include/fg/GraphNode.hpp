@@ -1,6 +1,6 @@
 #pragma once
 
-#include <string>
+#include "fg/NameTable.hpp"
 #include <cstdint>
 
 class FrameGraph;
@@ -18,15 +18,17 @@ public:
   GraphNode &operator=(GraphNode &&) noexcept = delete;
 
   [[nodiscard]] auto getId() const { return m_id; }
-  [[nodiscard]] std::string_view getName() const { return m_name; }
+  [[nodiscard]] auto getName() const { return m_name.string; }
+  /** @return Interned name id, equal names have equal ids. */
+  [[nodiscard]] auto getNameId() const { return m_name.id; }
   [[nodiscard]] auto getRefCount() const { return m_refCount; }
 
 protected:
-  GraphNode(const std::string_view name, uint32_t id)
+  GraphNode(const NameTable::Name name, uint32_t id)
       : m_name{name}, m_id{id} {}
 
 private:
-  std::string m_name;
+  NameTable::Name m_name; // Owned by FrameGraph::m_names.
   // Unique id, matches an array index in FrameGraph.
   const uint32_t m_id;
   int32_t m_refCount{0};
@@ -3,6 +3,7 @@
 #include "fg/PassNode.hpp"
 #include "fg/ResourceNode.hpp"
 #include "fg/ResourceEntry.hpp"
+#include <string>
 #include <vector>
 
 namespace graphviz {
@@ -213,6 +214,8 @@ struct Writer {
   const Colors colors;
 
   Graph graph{};
+  // Keys of passes that read a ResourceNode (at index of its id).
+  std::vector<std::vector<std::string>> readers;
 
   void operator()(const PassNode &, const std::vector<ResourceNode> &);
   void operator()(const ResourceNode &, const ResourceEntry &,
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// https://www.boost.org/doc/libs/1_81_0/libs/container_hash/doc/html/hash.html#notes_hash_combine
+
+template <typename T>
+inline void hashCombine(std::size_t &seed, const T &value) {
+  seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// FNV-1a, over 32-bit words instead of bytes (one step per word).
+constexpr auto kHashSeed = static_cast<std::size_t>(14695981039346656037ull);
+[[nodiscard]] inline std::size_t hashWord(std::size_t hash, uint32_t word) {
+  return (hash ^ word) * static_cast<std::size_t>(1099511628211ull);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+class PassNode;
+
+/**
+ * Receives begin/end events of passes (and phases of their execution) from
+ * FrameGraph::execute().
+ * @remark Requires FG_ENABLE_INSTRUMENTATION (CMake: FG_BUILD_INSTRUMENTATION),
+ * otherwise calls are compiled out.
+ * @remark Invoked concurrently by the parallel execute().
+ */
+class FrameGraphInstrumentation {
+public:
+  virtual ~FrameGraphInstrumentation() = default;
+
+  enum class Phase : uint8_t {
+    Create,   // Transients acquired by a pass.
+    Barriers, // preRead/preWrite or the barrier handler, split transitions.
+    Execute,  // Execution callback.
+    Destroy,  // Transients released after a pass.
+  };
+  [[nodiscard]] static const char *toString(Phase);
+
+  /** Encloses all phases of the pass. */
+  virtual void beginPass(const PassNode &, uint32_t workerIndex) = 0;
+  virtual void endPass(const PassNode &, uint32_t workerIndex) = 0;
+
+  virtual void beginPhase(Phase, const PassNode &, uint32_t workerIndex) = 0;
+  virtual void endPhase(Phase, const PassNode &, uint32_t workerIndex) = 0;
+};
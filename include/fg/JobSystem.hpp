@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Interface to a job system used by the parallel FrameGraph::execute().
+class FrameGraphJobSystem {
+public:
+  FrameGraphJobSystem() = default;
+  FrameGraphJobSystem(const FrameGraphJobSystem &) = delete;
+  FrameGraphJobSystem(FrameGraphJobSystem &&) noexcept = delete;
+  virtual ~FrameGraphJobSystem() = default;
+
+  FrameGraphJobSystem &operator=(const FrameGraphJobSystem &) = delete;
+  FrameGraphJobSystem &operator=(FrameGraphJobSystem &&) noexcept = delete;
+
+  struct Job {
+    void (*function)(void *data, uint32_t workerIndex);
+    void *data;
+  };
+
+  [[nodiscard]] virtual uint32_t getNumWorkers() const = 0;
+  /**
+   * Schedules the given job, may be called from within a job.
+   * @remark The job has to be invoked with an index of a worker that runs it,
+   * in range [0, getNumWorkers()).
+   */
+  virtual void submit(const Job &) = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator for per-frame objects. Memory is released all at once with
+ * reset(), without being returned to the system, so steady-state frames don't
+ * allocate.
+ * @note Destructors are not called, use ArenaPtr for objects that need it.
+ */
+class LinearAllocator final {
+public:
+  static constexpr std::size_t kDefaultBlockSize{64 * 1024};
+
+  explicit LinearAllocator(std::size_t blockSize = kDefaultBlockSize);
+  LinearAllocator(const LinearAllocator &) = delete;
+  /** Leaves the other one empty (and usable). */
+  LinearAllocator(LinearAllocator &&) noexcept;
+  ~LinearAllocator() = default;
+
+  LinearAllocator &operator=(const LinearAllocator &) = delete;
+  LinearAllocator &operator=(LinearAllocator &&) noexcept;
+
+  [[nodiscard]] void *allocate(std::size_t size, std::size_t alignment);
+
+  template <typename T, typename... Args> [[nodiscard]] T *make(Args &&...);
+
+  /** Invalidates all allocations, keeps the memory. */
+  void reset();
+
+  /** @return Size of all blocks (in bytes). */
+  [[nodiscard]] std::size_t getCapacity() const;
+  /** @return Number of bytes allocated since the last reset(). */
+  [[nodiscard]] auto getSize() const { return m_size; }
+
+private:
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    std::size_t size;
+  };
+  std::size_t m_blockSize;
+  std::vector<Block> m_blocks;
+  std::size_t m_currentBlock{0};
+  std::size_t m_offset{0}; // Within current block.
+  std::size_t m_size{0};
+};
+
+template <typename T, typename... Args>
+inline T *LinearAllocator::make(Args &&...args) {
+  return new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+}
+
+// Calls destructor of an object allocated with LinearAllocator, the memory
+// itself is reclaimed by LinearAllocator::reset().
+struct ArenaDeleter {
+  template <typename T> void operator()(T *ptr) const { ptr->~T(); }
+};
+template <typename T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "fg/LinearAllocator.hpp"
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * Interns names of graph nodes, each distinct name is stored once and gets an
+ * id (equal names have equal ids). Names are kept until clear(), so nodes
+ * declared every frame under the same names don't allocate.
+ */
+class NameTable final {
+public:
+  struct Name {
+    std::string_view string; // Owned by NameTable.
+    uint32_t id;
+  };
+
+  NameTable();
+  NameTable(const NameTable &) = delete;
+  NameTable(NameTable &&) noexcept = default;
+  ~NameTable() = default;
+
+  NameTable &operator=(const NameTable &) = delete;
+  NameTable &operator=(NameTable &&) noexcept = default;
+
+  [[nodiscard]] Name intern(const std::string_view);
+
+  /** Invalidates all names (and views to them). */
+  void clear();
+
+  [[nodiscard]] auto size() const { return uint32_t(m_ids.size()); }
+
+private:
+  LinearAllocator m_storage;
+  std::unordered_map<std::string_view, uint32_t> m_ids;
+};
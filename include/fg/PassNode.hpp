@@ -3,6 +3,9 @@
 #include "fg/GraphNode.hpp"
 #include "fg/PassEntry.hpp"
 #include "fg/FrameGraphResource.hpp"
+#include "fg/LinearAllocator.hpp"
+#include "fg/SmallVector.hpp"
+#include "fg/QueueSystem.hpp"
 #include <memory>
 #include <vector>
 
@@ -30,33 +33,69 @@ public:
   [[nodiscard]] bool writes(FrameGraphResource id) const;
 
   [[nodiscard]] auto hasSideEffect() const { return m_hasSideEffect; }
+  [[nodiscard]] auto getQueue() const { return m_queue; }
   [[nodiscard]] auto canExecute() const {
     return getRefCount() > 0 || hasSideEffect();
   }
 
   struct Create {};
-  [[nodiscard]] decltype(auto) each(const Create) const { return m_creates; }
+  [[nodiscard]] const auto &each(const Create) const { return m_creates; }
   struct Read {};
-  [[nodiscard]] decltype(auto) each(const Read) const { return m_reads; }
+  [[nodiscard]] const auto &each(const Read) const { return m_reads; }
   struct Write {};
-  [[nodiscard]] decltype(auto) each(const Write) const { return m_writes; }
+  [[nodiscard]] const auto &each(const Write) const { return m_writes; }
 
 private:
-  PassNode(const std::string_view name, uint32_t nodeId,
-           std::unique_ptr<FrameGraphPassConcept> &&);
+  PassNode(const NameTable::Name name, uint32_t nodeId,
+           ArenaPtr<FrameGraphPassConcept> &&);
+  /** Reuses the storage of a node from the previous frame. */
+  PassNode(const NameTable::Name name, uint32_t nodeId,
+           ArenaPtr<FrameGraphPassConcept> &&, PassNode &&recycled);
 
+  FrameGraphResource _create(FrameGraphResource id);
   FrameGraphResource _read(FrameGraphResource id, uint32_t flags);
   [[nodiscard]] FrameGraphResource _write(FrameGraphResource id,
                                           uint32_t flags);
 
+  enum AccessBits : uint8_t {
+    kCreate = 1 << 0,
+    kRead = 1 << 1,
+    kWrite = 1 << 2,
+  };
+  [[nodiscard]] uint32_t _findSlot(FrameGraphResource id) const;
+  [[nodiscard]] bool _hasAccess(FrameGraphResource id, uint8_t access) const;
+  void _addAccess(FrameGraphResource id, uint8_t access);
+  void _insertIndex(FrameGraphResource id, uint8_t access);
+  void _rebuildIndex(uint32_t capacity);
+
 private:
-  std::unique_ptr<FrameGraphPassConcept> m_exec;
+  ArenaPtr<FrameGraphPassConcept> m_exec;
+
+  // Inline capacity covers a typical pass, a write of a resource that the
+  // pass doesn't create is also a read (of the previous version).
+  SmallVector<FrameGraphResource, 4> m_creates;
+  SmallVector<AccessDeclaration, 8> m_reads;
+  SmallVector<AccessDeclaration, 4> m_writes;
+
+  // Access lookup (open addressing, ResourceNode id -> AccessBits), built
+  // once a pass declares more than kIndexThreshold accesses. Declarations of
+  // smaller passes are scanned instead.
+  static constexpr uint32_t kIndexThreshold{16};
+  static constexpr FrameGraphResource kEmptySlot{-1};
+  struct IndexSlot {
+    FrameGraphResource id{kEmptySlot};
+    uint8_t access{0};
+  };
+  std::vector<IndexSlot> m_index;
+  uint32_t m_numIndexed{0};
 
-  std::vector<FrameGraphResource> m_creates;
-  std::vector<AccessDeclaration> m_reads;
-  std::vector<AccessDeclaration> m_writes;
+  // Indices to virtual resources (FrameGraph::m_resourceRegistry), built in
+  // FrameGraph::compile() from the resources lifetime.
+  std::vector<uint32_t> m_acquires; // Transients to create before execution.
+  std::vector<uint32_t> m_releases; // Transients to destroy after execution.
 
   bool m_hasSideEffect{false};
+  FrameGraphQueue m_queue{FrameGraphQueue::Graphics};
 };
 
 #if __cplusplus < 202002L
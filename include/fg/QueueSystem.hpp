@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// Queue class of a pass (FrameGraph::Builder::setQueue).
+enum class FrameGraphQueue : uint8_t { Graphics, Compute, Transfer };
+
+// Interface to (GPU) queues used by FrameGraph::execute() with sync points.
+// Each queue has a timeline (e.g. a timeline semaphore or a fence) that
+// counts passes executed on it, starting from 0 at each execute().
+class FrameGraphQueueSystem {
+public:
+  FrameGraphQueueSystem() = default;
+  FrameGraphQueueSystem(const FrameGraphQueueSystem &) = delete;
+  FrameGraphQueueSystem(FrameGraphQueueSystem &&) noexcept = delete;
+  virtual ~FrameGraphQueueSystem() = default;
+
+  FrameGraphQueueSystem &operator=(const FrameGraphQueueSystem &) = delete;
+  FrameGraphQueueSystem &operator=(FrameGraphQueueSystem &&) noexcept = delete;
+
+  static constexpr uint32_t kNumQueues{3};
+
+  /** @return Context for passes that execute on the given queue. */
+  [[nodiscard]] virtual void *getContext(FrameGraphQueue) = 0;
+  /**
+   * Sets the timeline of the queue to the given value once the work recorded
+   * so far (on that queue) is done.
+   */
+  virtual void signal(FrameGraphQueue, uint32_t value) = 0;
+  /**
+   * Blocks the work recorded next on the queue until the timeline of another
+   * queue reaches the given value.
+   */
+  virtual void wait(FrameGraphQueue, FrameGraphQueue signaled,
+                    uint32_t value) = 0;
+};
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "fg/TypeTraits.hpp"
-#include <memory>
+#include "fg/LinearAllocator.hpp"
+#include <string>
+
+class FrameGraphResourcePool;
 
 // Wrapper around a virtual resource.
 class ResourceEntry final {
@@ -18,11 +21,19 @@ public:
   ResourceEntry &operator=(ResourceEntry &&) noexcept = delete;
 
   static constexpr auto kInitialVersion{1u};
+  static constexpr auto kInvalidHeapOffset{~uint64_t{0}};
+
+  struct MemoryRequirements {
+    uint64_t size{0}; // 0 = Not aliasable.
+    uint64_t alignment{1};
+  };
 
   [[nodiscard]] auto toString() const { return m_concept->toString(); }
 
-  void create(void *allocator);
-  void destroy(void *allocator);
+  /** @param pool Optional, a poolable resource is taken from it if possible. */
+  void create(void *allocator, FrameGraphResourcePool *pool = nullptr);
+  /** @param pool Optional, takes over a poolable resource (no T::destroy). */
+  void destroy(void *allocator, FrameGraphResourcePool *pool = nullptr);
 
   void preRead(uint32_t flags, void *context) {
     m_concept->preRead(flags, context);
@@ -30,19 +41,42 @@ public:
   void preWrite(uint32_t flags, void *context) {
     m_concept->preWrite(flags, context);
   }
+  /** @return True if T implements beginTransition/endTransition. */
+  [[nodiscard]] auto hasSplitTransitions() const {
+    return m_concept->hasSplitTransitions();
+  }
+  void beginTransition(uint32_t previousFlags, uint32_t nextFlags,
+                       void *context) {
+    m_concept->beginTransition(previousFlags, nextFlags, context);
+  }
+  void endTransition(uint32_t previousFlags, uint32_t nextFlags,
+                     void *context) {
+    m_concept->endTransition(previousFlags, nextFlags, context);
+  }
 
   [[nodiscard]] auto getId() const { return m_id; }
   [[nodiscard]] auto getVersion() const { return m_version; }
   [[nodiscard]] auto isImported() const { return m_type == Type::Imported; }
   [[nodiscard]] auto isTransient() const { return m_type == Type::Transient; }
 
+  [[nodiscard]] auto getMemoryRequirements() const {
+    return m_concept->getMemoryRequirements();
+  }
+  /**
+   * @return Offset in the transient heap (assigned by FrameGraph::compile()),
+   * or kInvalidHeapOffset if the resource is not aliased.
+   */
+  [[nodiscard]] auto getHeapOffset() const { return m_heapOffset; }
+
   template <typename T> [[nodiscard]] T &get();
   template <typename T>
   [[nodiscard]] const typename T::Desc &getDescriptor() const;
 
 private:
+  /** @param arena Storage for the type-erased resource. */
   template <typename T>
-  ResourceEntry(const Type, uint32_t id, const typename T::Desc &, T &&);
+  ResourceEntry(const Type, uint32_t id, const typename T::Desc &, T &&,
+                LinearAllocator &arena);
 
   // http://www.cplusplus.com/articles/oz18T05o/
   // https://www.modernescpp.com/index.php/c-core-guidelines-type-erasure-with-templates
@@ -50,19 +84,28 @@ private:
   struct Concept {
     virtual ~Concept() = default;
 
-    virtual void create(void *) = 0;
-    virtual void destroy(void *) = 0;
+    virtual void create(void *, uint64_t heapOffset,
+                        FrameGraphResourcePool *) = 0;
+    virtual void destroy(void *, FrameGraphResourcePool *) = 0;
 
     virtual void preRead(uint32_t flags, void *) = 0;
     virtual void preWrite(uint32_t flags, void *) = 0;
 
+    virtual bool hasSplitTransitions() const = 0;
+    virtual void beginTransition(uint32_t previousFlags, uint32_t nextFlags,
+                                 void *) = 0;
+    virtual void endTransition(uint32_t previousFlags, uint32_t nextFlags,
+                               void *) = 0;
+
     virtual std::string toString() const = 0;
+    virtual MemoryRequirements getMemoryRequirements() const = 0;
   };
   template <typename T> struct Model final : Concept {
     Model(const typename T::Desc &, T &&);
 
-    void create(void *allocator) override;
-    void destroy(void *allocator) override;
+    void create(void *allocator, uint64_t heapOffset,
+                FrameGraphResourcePool *) override;
+    void destroy(void *allocator, FrameGraphResourcePool *) override;
 
     void preRead(uint32_t flags, void *context) override {
 #if __cplusplus >= 202002L
@@ -81,7 +124,22 @@ private:
         resource.preWrite(descriptor, flags, context);
     }
 
+    bool hasSplitTransitions() const override {
+      return has_splitTransitions<T>;
+    }
+    void beginTransition(uint32_t previousFlags, uint32_t nextFlags,
+                         void *context) override {
+      if constexpr (has_splitTransitions<T>)
+        resource.beginTransition(descriptor, previousFlags, nextFlags, context);
+    }
+    void endTransition(uint32_t previousFlags, uint32_t nextFlags,
+                       void *context) override {
+      if constexpr (has_splitTransitions<T>)
+        resource.endTransition(descriptor, previousFlags, nextFlags, context);
+    }
+
     std::string toString() const override;
+    MemoryRequirements getMemoryRequirements() const override;
 
     const typename T::Desc descriptor;
     T resource;
@@ -91,12 +149,16 @@ private:
 
 private:
   const Type m_type;
-  const uint32_t m_id;
+  const TypeId m_typeId; // Of T (resource), validated in _getModel.
+  uint32_t m_id; // Changes when a recorder is merged.
   uint32_t m_version; // Incremented on each (unique) write declaration.
-  std::unique_ptr<Concept> m_concept;
+  ArenaPtr<Concept> m_concept;
+  uint64_t m_heapOffset{kInvalidHeapOffset};
 
-  PassNode *m_producer{nullptr};
-  PassNode *m_last{nullptr};
+  static constexpr auto kInvalidPassId{~0u};
+  // Lifetime (PassNode ids), assigned by FrameGraph::compile().
+  uint32_t m_producer{kInvalidPassId};
+  uint32_t m_last{kInvalidPassId};
 };
 
 #include "ResourceEntry.inl"
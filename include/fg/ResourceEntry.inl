@@ -1,16 +1,19 @@
+#include "fg/ResourcePool.hpp"
 #include <cassert>
 
 //
 // ResourceEntry class:
 //
 
-inline void ResourceEntry::create(void *allocator) {
+inline void ResourceEntry::create(void *allocator,
+                                  FrameGraphResourcePool *pool) {
   assert(isTransient());
-  m_concept->create(allocator);
+  m_concept->create(allocator, m_heapOffset, pool);
 }
-inline void ResourceEntry::destroy(void *allocator) {
+inline void ResourceEntry::destroy(void *allocator,
+                                   FrameGraphResourcePool *pool) {
   assert(isTransient());
-  m_concept->destroy(allocator);
+  m_concept->destroy(allocator, pool);
 }
 
 template <typename T> inline T &ResourceEntry::get() {
@@ -27,14 +30,15 @@ inline const typename T::Desc &ResourceEntry::getDescriptor() const {
 
 template <typename T>
 inline ResourceEntry::ResourceEntry(const Type type, uint32_t id,
-                                    const typename T::Desc &desc, T &&obj)
-    : m_type{type}, m_id{id}, m_version{kInitialVersion},
-      m_concept{std::make_unique<Model<T>>(desc, std::forward<T>(obj))} {}
+                                    const typename T::Desc &desc, T &&obj,
+                                    LinearAllocator &arena)
+    : m_type{type}, m_typeId{typeId<T>()}, m_id{id},
+      m_version{kInitialVersion},
+      m_concept{arena.make<Model<T>>(desc, std::forward<T>(obj))} {}
 
 template <typename T> inline auto *ResourceEntry::_getModel() const {
-  auto *model = dynamic_cast<Model<T> *>(m_concept.get());
-  assert(model && "Invalid type");
-  return model;
+  assert(m_typeId == typeId<T>() && "Invalid type");
+  return static_cast<Model<T> *>(m_concept.get());
 }
 
 //
@@ -46,11 +50,33 @@ inline ResourceEntry::Model<T>::Model(const typename T::Desc &desc, T &&obj)
     : descriptor{desc}, resource{std::move(obj)} {}
 
 template <typename T>
-inline void ResourceEntry::Model<T>::create(void *allocator) {
-  resource.create(descriptor, allocator);
+inline void ResourceEntry::Model<T>::create(
+  void *allocator, [[maybe_unused]] uint64_t heapOffset,
+  [[maybe_unused]] FrameGraphResourcePool *pool) {
+#if __cplusplus >= 202002L
+  if constexpr (has_memoryRequirements<T>)
+#else
+  if constexpr (has_memoryRequirements<T>::value)
+#endif
+  {
+    assert(heapOffset != kInvalidHeapOffset);
+    resource.create(descriptor, allocator, heapOffset);
+  } else {
+    if constexpr (FrameGraphResourcePool::isPoolable<T>()) {
+      if (pool && pool->acquire(descriptor, resource)) return;
+    }
+    resource.create(descriptor, allocator);
+  }
 }
 template <typename T>
-inline void ResourceEntry::Model<T>::destroy(void *allocator) {
+inline void ResourceEntry::Model<T>::destroy(
+  void *allocator, [[maybe_unused]] FrameGraphResourcePool *pool) {
+  if constexpr (FrameGraphResourcePool::isPoolable<T>()) {
+    if (pool) {
+      pool->release(descriptor, std::move(resource));
+      return;
+    }
+  }
   resource.destroy(descriptor, allocator);
 }
 
@@ -65,3 +91,19 @@ inline std::string ResourceEntry::Model<T>::toString() const {
   else
     return "";
 }
+
+template <typename T>
+inline ResourceEntry::MemoryRequirements
+ResourceEntry::Model<T>::getMemoryRequirements() const {
+#if __cplusplus >= 202002L
+  if constexpr (has_memoryRequirements<T>)
+#else
+  if constexpr (has_memoryRequirements<T>::value)
+#endif
+  {
+    const auto requirements = T::memoryRequirements(descriptor);
+    return {requirements.size, requirements.alignment};
+  } else {
+    return {};
+  }
+}
@@ -2,8 +2,6 @@
 
 #include "fg/GraphNode.hpp"
 
-class PassNode;
-
 class ResourceNode final : public GraphNode {
   friend class FrameGraph;
 
@@ -18,7 +16,7 @@ public:
   [[nodiscard]] auto getVersion() const { return m_version; }
 
 private:
-  ResourceNode(const std::string_view name, uint32_t nodeId,
+  ResourceNode(const NameTable::Name name, uint32_t nodeId,
                uint32_t resourceId, uint32_t version)
       : GraphNode{name, nodeId}, m_resourceId{resourceId}, m_version{version} {}
 
@@ -26,7 +24,4 @@ private:
   // Index to virtual resource (FrameGraph::m_resourceRegistry).
   const uint32_t m_resourceId;
   const uint32_t m_version;
-
-  PassNode *m_producer{nullptr};
-  PassNode *m_last{nullptr};
 };
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "fg/TypeTraits.hpp"
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * Recycles transient resources between frames. Instead of being destroyed, a
+ * transient is returned to the pool and handed over to a transient (of the
+ * same type) with an equal descriptor in a next frame.
+ * Applies to move assignable resources with T::Desc that is hashable
+ * (std::hash) and equality comparable, and that are not aliased (without
+ * memoryRequirements).
+ */
+class FrameGraphResourcePool {
+public:
+  /** @param maxUnusedFrames Resources unused for longer are destroyed. */
+  explicit FrameGraphResourcePool(uint32_t maxUnusedFrames = 3);
+  FrameGraphResourcePool(const FrameGraphResourcePool &) = delete;
+  FrameGraphResourcePool(FrameGraphResourcePool &&) noexcept = default;
+  /** @remark Use clear() first, pooled resources are not destroyed. */
+  ~FrameGraphResourcePool() = default;
+
+  FrameGraphResourcePool &operator=(const FrameGraphResourcePool &) = delete;
+  FrameGraphResourcePool &operator=(FrameGraphResourcePool &&) noexcept =
+    default;
+
+  template <typename T> static constexpr bool isPoolable();
+
+  /**
+   * @return True if the resource has been taken from the pool, otherwise it
+   * has to be created.
+   */
+  template <typename T>
+  [[nodiscard]] bool acquire(const typename T::Desc &, T &);
+  /** Takes over the given resource (instead of T::destroy). */
+  template <typename T> void release(const typename T::Desc &, T &&);
+
+  /**
+   * Advances the frame counter and destroys resources that have been unused
+   * for too long. Call once per frame (after FrameGraph::execute).
+   */
+  void update(void *allocator);
+  /** Destroys all pooled resources. */
+  void clear(void *allocator);
+
+  struct Stats {
+    uint32_t numHits{0};
+    uint32_t numMisses{0};
+    uint32_t numEvictions{0};
+    // Resources waiting in the pool.
+    uint32_t numPooled{0};
+  };
+  [[nodiscard]] const auto &getStats() const { return m_stats; }
+
+private:
+  struct Slot {
+    Slot(TypeId type_) : type{type_} {}
+    virtual ~Slot() = default;
+
+    virtual void destroy(void *allocator) = 0;
+
+    const TypeId type;
+    uint64_t lastUsed{0};
+    bool occupied{false};
+  };
+  template <typename T> struct SlotModel final : Slot {
+    SlotModel() : Slot{typeId<T>()} {}
+
+    void destroy(void *allocator) override {
+      resource.destroy(descriptor, allocator);
+    }
+
+    typename T::Desc descriptor{};
+    T resource;
+  };
+
+  template <typename T>
+  [[nodiscard]] static std::size_t _makeKey(const typename T::Desc &);
+
+private:
+  const uint32_t m_maxUnusedFrames;
+  uint64_t m_frame{0};
+
+  // Slots of resources with colliding keys share a bucket, an empty slot (the
+  // resource has been acquired) is refilled by a subsequent release.
+  std::unordered_map<std::size_t, std::vector<std::unique_ptr<Slot>>>
+    m_buckets;
+
+  Stats m_stats;
+};
+
+#include "fg/ResourcePool.inl"
@@ -0,0 +1,72 @@
+#include "fg/Hash.hpp"
+#include <cassert>
+
+template <typename T> constexpr bool FrameGraphResourcePool::isPoolable() {
+  using Desc = typename T::Desc;
+  // Resources are moved in and out of the pool.
+#if __cplusplus >= 202002L
+  return has_hash<Desc> && has_equality<Desc> &&
+         std::is_move_assignable_v<T> && !has_memoryRequirements<T>;
+#else
+  return has_hash<Desc>::value && has_equality<Desc>::value &&
+         std::is_move_assignable_v<T> && !has_memoryRequirements<T>::value;
+#endif
+}
+
+template <typename T>
+inline bool FrameGraphResourcePool::acquire(const typename T::Desc &desc,
+                                            T &resource) {
+  static_assert(isPoolable<T>());
+  if (auto it = m_buckets.find(_makeKey<T>(desc)); it != m_buckets.end()) {
+    for (auto &slot : it->second) {
+      if (!slot->occupied || slot->type != typeId<T>()) continue;
+
+      auto &model = static_cast<SlotModel<T> &>(*slot);
+      if (!(model.descriptor == desc)) continue;
+
+      resource = std::move(model.resource);
+      model.occupied = false;
+      model.lastUsed = m_frame;
+      ++m_stats.numHits;
+      --m_stats.numPooled;
+      return true;
+    }
+  }
+  ++m_stats.numMisses;
+  return false;
+}
+template <typename T>
+inline void FrameGraphResourcePool::release(const typename T::Desc &desc,
+                                            T &&resource) {
+  static_assert(isPoolable<T>());
+  auto &slots = m_buckets[_makeKey<T>(desc)];
+  SlotModel<T> *model{nullptr};
+  for (auto &slot : slots) {
+    if (!slot->occupied && slot->type == typeId<T>()) {
+      model = static_cast<SlotModel<T> *>(slot.get());
+      break;
+    }
+  }
+  if (!model) {
+    model = static_cast<SlotModel<T> *>(
+      slots.emplace_back(std::make_unique<SlotModel<T>>()).get());
+  }
+  model->descriptor = desc;
+  model->resource = std::move(resource);
+  model->occupied = true;
+  model->lastUsed = m_frame;
+  ++m_stats.numPooled;
+}
+
+//
+// (private):
+//
+
+template <typename T>
+inline std::size_t
+FrameGraphResourcePool::_makeKey(const typename T::Desc &desc) {
+  std::size_t seed{0};
+  hashCombine(seed, typeId<T>());
+  hashCombine(seed, desc);
+  return seed;
+}
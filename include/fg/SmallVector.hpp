@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * Vector with inline storage for N elements, allocates only when it grows
+ * beyond that. Once allocated, the storage is kept until destruction (clear()
+ * does not release it).
+ * @note Limited to trivially copyable types.
+ */
+template <typename T, uint32_t N> class SmallVector final {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                std::is_default_constructible_v<T>);
+  static_assert(N > 0);
+
+public:
+  SmallVector() = default;
+  SmallVector(const SmallVector &) = delete;
+  SmallVector(SmallVector &&other) noexcept { *this = std::move(other); }
+  ~SmallVector() = default;
+
+  SmallVector &operator=(const SmallVector &) = delete;
+  SmallVector &operator=(SmallVector &&other) noexcept {
+    if (this != &other) {
+      m_heap = std::move(other.m_heap);
+      m_size = other.m_size;
+      m_capacity = other.m_capacity;
+      if (!m_heap) std::copy_n(other.m_inline, m_size, m_inline);
+
+      other.m_size = 0;
+      other.m_capacity = N;
+    }
+    return *this;
+  }
+
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    if (m_size == m_capacity) _grow(m_capacity * 2);
+    return data()[m_size++] = T{std::forward<Args>(args)...};
+  }
+  void reserve(uint32_t capacity) {
+    if (capacity > m_capacity) _grow(capacity);
+  }
+  void clear() { m_size = 0; }
+
+  [[nodiscard]] T *data() { return m_heap ? m_heap.get() : m_inline; }
+  [[nodiscard]] const T *data() const {
+    return m_heap ? m_heap.get() : m_inline;
+  }
+
+  [[nodiscard]] T &operator[](uint32_t i) {
+    assert(i < m_size);
+    return data()[i];
+  }
+  [[nodiscard]] const T &operator[](uint32_t i) const {
+    assert(i < m_size);
+    return data()[i];
+  }
+
+  [[nodiscard]] auto size() const { return m_size; }
+  [[nodiscard]] auto capacity() const { return m_capacity; }
+  [[nodiscard]] auto empty() const { return m_size == 0; }
+  /** @return true if elements are stored inline (no allocation). */
+  [[nodiscard]] auto isInline() const { return !m_heap; }
+
+  [[nodiscard]] T *begin() { return data(); }
+  [[nodiscard]] T *end() { return data() + m_size; }
+  [[nodiscard]] const T *begin() const { return data(); }
+  [[nodiscard]] const T *end() const { return data() + m_size; }
+  [[nodiscard]] const T *cbegin() const { return begin(); }
+  [[nodiscard]] const T *cend() const { return end(); }
+
+private:
+  void _grow(uint32_t capacity) {
+    auto heap = std::make_unique<T[]>(capacity);
+    std::copy_n(data(), m_size, heap.get());
+    m_heap = std::move(heap);
+    m_capacity = capacity;
+  }
+
+private:
+  T m_inline[N]{};
+  std::unique_ptr<T[]> m_heap;
+  uint32_t m_size{0};
+  uint32_t m_capacity{N};
+};
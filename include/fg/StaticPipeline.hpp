@@ -0,0 +1,275 @@
+#pragma once
+
+#include "fg/TypeTraits.hpp"
+#include <tuple>
+#include <array>
+#include <utility>
+#include <memory>
+#include <new>
+
+// Resources of FrameGraphStaticPipeline are types, Tag tells apart the ones of
+// the same T.
+template <typename Tag, _VIRTUALIZABLE_CONCEPT(T)>
+struct FrameGraphStaticTransient {
+  using Type = T;
+  static constexpr bool kImported{false};
+};
+// Neither created nor destroyed by the pipeline (see import()).
+template <typename Tag, _VIRTUALIZABLE_CONCEPT(T)>
+struct FrameGraphStaticImported {
+  using Type = T;
+  static constexpr bool kImported{true};
+};
+// Access with flags (for T::preRead/T::preWrite) in Reads/Writes of a pass, a
+// plain resource is accessed with FrameGraph::kFlagsIgnored.
+template <typename Resource, uint32_t Flags> struct FrameGraphStaticAccess {};
+
+/**
+ * Graph of passes known at compile time (e.g. of a fixed pipeline). Culling,
+ * the order of execution and lifetimes of transients are computed by the
+ * compiler, execute() invokes passes and resources without virtual calls.
+ * A pass is a type with:
+ * - Reads, Writes: std::tuple of resources (or FrameGraphStaticAccess)
+ * - kSideEffect: static constexpr bool (optional)
+ * - operator()(const Reads::Type &..., Writes::Type &..., void *context)
+ * Passes execute in the order of declaration (culled ones are skipped). The
+ * first write of a transient creates it, a later write reads it as well.
+ */
+template <typename... Passes> class FrameGraphStaticPipeline {
+  static_assert(sizeof...(Passes) > 0);
+
+  static constexpr uint32_t kFlagsIgnored{~0u};
+
+  template <typename Access> struct Unwrap {
+    using Resource = Access;
+    static constexpr uint32_t kFlags{kFlagsIgnored};
+  };
+  template <typename R, uint32_t Flags>
+  struct Unwrap<FrameGraphStaticAccess<R, Flags>> {
+    using Resource = R;
+    static constexpr uint32_t kFlags{Flags};
+  };
+  template <typename List> struct ResourcesOf;
+  template <typename... Accesses> struct ResourcesOf<std::tuple<Accesses...>> {
+    using type = std::tuple<typename Unwrap<Accesses>::Resource...>;
+  };
+  template <typename Pass>
+  using AccessesOf = typename ResourcesOf<decltype(std::tuple_cat(
+    std::declval<typename Pass::Reads>(),
+    std::declval<typename Pass::Writes>()))>::type;
+
+  template <typename Unique, typename... Ts> struct Deduplicate {
+    using type = Unique;
+  };
+  template <typename... Us, typename T, typename... Ts>
+  struct Deduplicate<std::tuple<Us...>, T, Ts...>
+      : Deduplicate<std::conditional_t<(std::is_same_v<T, Us> || ...),
+                                       std::tuple<Us...>, std::tuple<Us..., T>>,
+                    Ts...> {};
+  template <typename List> struct Unique;
+  template <typename... Ts>
+  struct Unique<std::tuple<Ts...>> : Deduplicate<std::tuple<>, Ts...> {};
+
+  template <typename T, typename List> struct IndexOf;
+  template <typename T, typename... Ts> struct IndexOf<T, std::tuple<Ts...>> {
+    static constexpr auto value = [] {
+      constexpr std::array<bool, sizeof...(Ts)> same{std::is_same_v<T, Ts>...};
+      auto i = 0u;
+      while (i < same.size() && !same[i])
+        ++i;
+      return i;
+    }();
+    static_assert(value < sizeof...(Ts), "Not in the pipeline");
+  };
+
+  template <typename Pass, typename = void>
+  struct SideEffect : std::false_type {};
+  template <typename Pass>
+  struct SideEffect<Pass, std::void_t<decltype(Pass::kSideEffect)>>
+      : std::bool_constant<Pass::kSideEffect> {};
+
+public:
+  // In the order of the first access.
+  using Resources = typename Unique<decltype(std::tuple_cat(
+    std::declval<AccessesOf<Passes>>()...))>::type;
+
+  static constexpr auto kNumPasses = uint32_t(sizeof...(Passes));
+  static constexpr auto kNumResources = uint32_t(std::tuple_size_v<Resources>);
+
+private:
+  using Mask = std::array<bool, kNumResources>; // Per resource.
+  template <typename List> struct MaskOf;
+  template <typename... Accesses> struct MaskOf<std::tuple<Accesses...>> {
+    static constexpr auto value = [] {
+      Mask mask{};
+      ((mask[IndexOf<typename Unwrap<Accesses>::Resource, Resources>::value] =
+          true),
+       ...);
+      return mask;
+    }();
+  };
+  template <typename List> struct ImportedOf;
+  template <typename... Rs> struct ImportedOf<std::tuple<Rs...>> {
+    static constexpr Mask value{Rs::kImported...};
+  };
+
+  // Declarations of passes:
+  static constexpr std::array<Mask, kNumPasses> kReads{
+    MaskOf<typename Passes::Reads>::value...};
+  static constexpr std::array<Mask, kNumPasses> kWrites{
+    MaskOf<typename Passes::Writes>::value...};
+  static constexpr std::array<bool, kNumPasses> kSideEffects{
+    SideEffect<Passes>::value...};
+  static constexpr Mask kImported{ImportedOf<Resources>::value};
+
+  // Written by an earlier pass (a write reads the previous content then).
+  static constexpr auto kWrittenBefore = [] {
+    std::array<Mask, kNumPasses> written{};
+    for (auto i = 1u; i < kNumPasses; ++i) {
+      for (auto r = 0u; r < kNumResources; ++r)
+        written[i][r] = written[i - 1][r] || kWrites[i - 1][r];
+    }
+    return written;
+  }();
+  static_assert(
+    [] {
+      for (auto i = 0u; i < kNumPasses; ++i) {
+        for (auto r = 0u; r < kNumResources; ++r) {
+          if (kReads[i][r] && (kWrites[i][r] || !(kWrittenBefore[i][r] ||
+                                                  kImported[r]))) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }(),
+    "A resource has to be written by an earlier pass (or imported) to be "
+    "read, a write implies the read");
+
+  // Culling, from the last pass (as with reference counts of FrameGraph).
+  static constexpr auto kExecuted = [] {
+    std::array<bool, kNumPasses> executed{};
+    Mask needed{}; // Content read by an executed (later) pass.
+    for (auto i = kNumPasses; i-- > 0;) {
+      auto execute = kSideEffects[i];
+      for (auto r = 0u; r < kNumResources; ++r)
+        execute = execute || (kWrites[i][r] && (needed[r] || kImported[r]));
+      if (!execute) continue;
+
+      executed[i] = true;
+      for (auto r = 0u; r < kNumResources; ++r) {
+        if (kWrites[i][r]) needed[r] = kWrittenBefore[i][r];
+        if (kReads[i][r]) needed[r] = true;
+      }
+    }
+    return executed;
+  }();
+  static constexpr auto kNumExecuted = [] {
+    auto count = 0u;
+    for (const auto executed : kExecuted)
+      count += executed;
+    return count;
+  }();
+
+  static constexpr auto kExecutionOrder = [] {
+    std::array<uint32_t, kNumExecuted> order{};
+    auto position = 0u;
+    for (auto i = 0u; i < kNumPasses; ++i) {
+      if (kExecuted[i]) order[position++] = i;
+    }
+    return order;
+  }();
+
+  static constexpr uint32_t kNotCreated{~0u};
+  // Of transients (indices of executed passes), created before the first one
+  // and destroyed after the last one.
+  struct Lifetime {
+    uint32_t first{kNotCreated};
+    uint32_t last{kNotCreated};
+  };
+  static constexpr auto kLifetimes = [] {
+    std::array<Lifetime, kNumResources> lifetimes{};
+    for (const auto i : kExecutionOrder) {
+      for (auto r = 0u; r < kNumResources; ++r) {
+        if (kImported[r] || !(kReads[i][r] || kWrites[i][r])) continue;
+        if (lifetimes[r].first == kNotCreated) lifetimes[r].first = i;
+        lifetimes[r].last = i;
+      }
+    }
+    return lifetimes;
+  }();
+
+public:
+  FrameGraphStaticPipeline() = default;
+  explicit FrameGraphStaticPipeline(Passes... passes)
+      : m_passes{std::move(passes)...} {}
+  FrameGraphStaticPipeline(const FrameGraphStaticPipeline &) = delete;
+  FrameGraphStaticPipeline(FrameGraphStaticPipeline &&) noexcept = default;
+
+  FrameGraphStaticPipeline &
+  operator=(const FrameGraphStaticPipeline &) = delete;
+  FrameGraphStaticPipeline &
+  operator=(FrameGraphStaticPipeline &&) noexcept = default;
+
+  /** @return Indices of passes (in Passes) in the order of execution. */
+  [[nodiscard]] static constexpr const auto &getExecutionOrder() {
+    return kExecutionOrder;
+  }
+  template <typename Pass> [[nodiscard]] static constexpr bool isCulled() {
+    return !kExecuted[IndexOf<Pass, std::tuple<Passes...>>::value];
+  }
+
+  template <typename Pass> [[nodiscard]] Pass &getPass() {
+    return std::get<Pass>(m_passes);
+  }
+
+  /** Sets the descriptor of a transient, used by the next execute(). */
+  template <typename Resource>
+  void setDescriptor(const typename Resource::Type::Desc &);
+  template <typename Resource>
+  [[nodiscard]] const typename Resource::Type::Desc &getDescriptor() const;
+
+  template <typename Resource>
+  void import(const typename Resource::Type::Desc &,
+              typename Resource::Type &&);
+  /** @remark Transients exist during execute() only. */
+  template <typename Resource> [[nodiscard]] typename Resource::Type &get();
+
+  /** Invokes passes that are not culled. */
+  void execute(void *context = nullptr, void *allocator = nullptr);
+
+private:
+  template <std::size_t... I>
+  void _execute(std::index_sequence<I...>, void *context, void *allocator);
+  template <uint32_t PassIndex>
+  void _executePass(void *context, void *allocator);
+  template <typename Pass, typename... Reads, typename... Writes>
+  void _invoke(Pass &, std::tuple<Reads...> *, std::tuple<Writes...> *,
+               void *context);
+
+  template <uint32_t PassIndex, std::size_t... R>
+  void _createTransients(void *allocator, std::index_sequence<R...>);
+  template <uint32_t PassIndex, std::size_t... R>
+  void _destroyTransients(void *allocator, std::index_sequence<R...>);
+
+  template <typename Access> void _preRead(void *context);
+  template <typename Access> void _preWrite(void *context);
+
+  template <typename Resource> struct Slot {
+    typename Resource::Type::Desc descriptor{};
+    typename Resource::Type resource{};
+  };
+  template <typename List> struct SlotsOf;
+  template <typename... Rs> struct SlotsOf<std::tuple<Rs...>> {
+    using type = std::tuple<Slot<Rs>...>;
+  };
+  template <typename Access> [[nodiscard]] auto &_getSlot() {
+    return std::get<Slot<typename Unwrap<Access>::Resource>>(m_slots);
+  }
+
+private:
+  std::tuple<Passes...> m_passes;
+  typename SlotsOf<Resources>::type m_slots;
+};
+
+#include "fg/StaticPipeline.inl"
@@ -0,0 +1,144 @@
+//
+// FrameGraphStaticPipeline class:
+//
+
+template <typename... Passes>
+template <typename Resource>
+inline void FrameGraphStaticPipeline<Passes...>::setDescriptor(
+  const typename Resource::Type::Desc &desc) {
+  static_assert(!Resource::kImported, "Descriptor of a transient");
+  _getSlot<Resource>().descriptor = desc;
+}
+template <typename... Passes>
+template <typename Resource>
+inline const typename Resource::Type::Desc &
+FrameGraphStaticPipeline<Passes...>::getDescriptor() const {
+  return std::get<Slot<Resource>>(m_slots).descriptor;
+}
+
+template <typename... Passes>
+template <typename Resource>
+inline void FrameGraphStaticPipeline<Passes...>::import(
+  const typename Resource::Type::Desc &desc,
+  typename Resource::Type &&resource) {
+  static_assert(Resource::kImported, "Use FrameGraphStaticImported");
+  using T = typename Resource::Type;
+  auto &slot = _getSlot<Resource>();
+  slot.descriptor = desc;
+  // Virtualizable T is move constructible, not necessarily assignable.
+  std::destroy_at(&slot.resource);
+  ::new (&slot.resource) T{std::move(resource)};
+}
+template <typename... Passes>
+template <typename Resource>
+inline typename Resource::Type &FrameGraphStaticPipeline<Passes...>::get() {
+  return _getSlot<Resource>().resource;
+}
+
+template <typename... Passes>
+inline void FrameGraphStaticPipeline<Passes...>::execute(void *context,
+                                                         void *allocator) {
+  _execute(std::make_index_sequence<kNumExecuted>{}, context, allocator);
+}
+
+//
+// (private):
+//
+
+template <typename... Passes>
+template <std::size_t... I>
+inline void
+FrameGraphStaticPipeline<Passes...>::_execute(std::index_sequence<I...>,
+                                              void *context, void *allocator) {
+  (_executePass<kExecutionOrder[I]>(context, allocator), ...);
+}
+template <typename... Passes>
+template <uint32_t PassIndex>
+inline void FrameGraphStaticPipeline<Passes...>::_executePass(void *context,
+                                                              void *allocator) {
+  using Pass = std::tuple_element_t<PassIndex, std::tuple<Passes...>>;
+  constexpr auto kResources = std::make_index_sequence<kNumResources>{};
+
+  _createTransients<PassIndex>(allocator, kResources);
+  _invoke(std::get<PassIndex>(m_passes),
+          static_cast<typename Pass::Reads *>(nullptr),
+          static_cast<typename Pass::Writes *>(nullptr), context);
+  _destroyTransients<PassIndex>(allocator, kResources);
+}
+template <typename... Passes>
+template <typename Pass, typename... Reads, typename... Writes>
+inline void
+FrameGraphStaticPipeline<Passes...>::_invoke(Pass &pass, std::tuple<Reads...> *,
+                                             std::tuple<Writes...> *,
+                                             void *context) {
+  static_assert(
+    std::is_invocable_v<Pass &,
+                        const typename Unwrap<Reads>::Resource::Type &...,
+                        typename Unwrap<Writes>::Resource::Type &..., void *>,
+    "Invalid pass");
+
+  (_preRead<Reads>(context), ...);
+  (_preWrite<Writes>(context), ...);
+  pass(std::as_const(_getSlot<Reads>().resource)...,
+       _getSlot<Writes>().resource..., context);
+}
+
+template <typename... Passes>
+template <uint32_t PassIndex, std::size_t... R>
+inline void FrameGraphStaticPipeline<Passes...>::_createTransients(
+  [[maybe_unused]] void *allocator, std::index_sequence<R...>) {
+  const auto create = [allocator](auto &slot) {
+    slot.resource.create(slot.descriptor, allocator);
+  };
+  ((kLifetimes[R].first == PassIndex
+      ? create(std::get<R>(m_slots))
+      : void()),
+   ...);
+}
+template <typename... Passes>
+template <uint32_t PassIndex, std::size_t... R>
+inline void FrameGraphStaticPipeline<Passes...>::_destroyTransients(
+  [[maybe_unused]] void *allocator, std::index_sequence<R...>) {
+  const auto destroy = [allocator](auto &slot) {
+    slot.resource.destroy(slot.descriptor, allocator);
+  };
+  ((kLifetimes[R].last == PassIndex
+      ? destroy(std::get<R>(m_slots))
+      : void()),
+   ...);
+}
+
+template <typename... Passes>
+template <typename Access>
+inline void FrameGraphStaticPipeline<Passes...>::_preRead(
+  [[maybe_unused]] void *context) {
+  using T = typename Unwrap<Access>::Resource::Type;
+  if constexpr (Unwrap<Access>::kFlags != kFlagsIgnored) {
+#if __cplusplus >= 202002L
+    if constexpr (has_preRead<T>)
+#else
+    if constexpr (has_preRead<T>::value)
+#endif
+    {
+      auto &slot = _getSlot<Access>();
+      slot.resource.preRead(slot.descriptor, Unwrap<Access>::kFlags, context);
+    }
+  }
+}
+template <typename... Passes>
+template <typename Access>
+inline void FrameGraphStaticPipeline<Passes...>::_preWrite(
+  [[maybe_unused]] void *context) {
+  using T = typename Unwrap<Access>::Resource::Type;
+  if constexpr (Unwrap<Access>::kFlags != kFlagsIgnored) {
+#if __cplusplus >= 202002L
+    if constexpr (has_preWrite<T>)
+#else
+    if constexpr (has_preWrite<T>::value)
+#endif
+    {
+      auto &slot = _getSlot<Access>();
+      slot.resource.preWrite(slot.descriptor, Unwrap<Access>::kFlags, context);
+    }
+  }
+}
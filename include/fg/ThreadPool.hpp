@@ -0,0 +1,42 @@
+#pragma once
+
+#include "fg/JobSystem.hpp"
+#include <deque>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Work-stealing thread pool, each worker has its own queue and steals from
+// others when it runs out of jobs.
+class FrameGraphThreadPool final : public FrameGraphJobSystem {
+public:
+  explicit FrameGraphThreadPool(
+    uint32_t numWorkers = std::thread::hardware_concurrency());
+  ~FrameGraphThreadPool() override;
+
+  [[nodiscard]] uint32_t getNumWorkers() const override;
+  void submit(const Job &) override;
+
+private:
+  void _run(uint32_t workerIndex);
+  [[nodiscard]] bool _tryPop(uint32_t workerIndex, Job &);
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+  const uint32_t m_numWorkers;
+  std::unique_ptr<Queue[]> m_queues;
+  std::atomic<uint32_t> m_nextQueue{0};
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  int64_t m_numPendingJobs{0}; // Guarded by m_mutex.
+  bool m_stop{false};          // Guarded by m_mutex.
+
+  std::vector<std::thread> m_threads;
+};
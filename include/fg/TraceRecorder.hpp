@@ -0,0 +1,63 @@
+#pragma once
+
+#include "fg/Instrumentation.hpp"
+#include "fg/NameTable.hpp"
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <ostream>
+
+/**
+ * Records timestamps of passes and phases, in the Chrome trace event format
+ * (https://ui.perfetto.dev, chrome://tracing).
+ * One thread per worker of the parallel execute().
+ * @remark Events are buffered per worker, query, write() and clear() only
+ * between calls to execute().
+ */
+class FrameGraphTraceRecorder final : public FrameGraphInstrumentation {
+public:
+  /**
+   * @param numWorkers FrameGraphJobSystem::getNumWorkers() of the parallel
+   * execute() (if any).
+   */
+  explicit FrameGraphTraceRecorder(uint32_t numWorkers = 1);
+  FrameGraphTraceRecorder(const FrameGraphTraceRecorder &) = delete;
+  FrameGraphTraceRecorder(FrameGraphTraceRecorder &&) noexcept = delete;
+  ~FrameGraphTraceRecorder() override = default;
+
+  FrameGraphTraceRecorder &operator=(const FrameGraphTraceRecorder &) = delete;
+  FrameGraphTraceRecorder &
+  operator=(FrameGraphTraceRecorder &&) noexcept = delete;
+
+  void beginPass(const PassNode &, uint32_t workerIndex) override;
+  void endPass(const PassNode &, uint32_t workerIndex) override;
+
+  void beginPhase(Phase, const PassNode &, uint32_t workerIndex) override;
+  void endPhase(Phase, const PassNode &, uint32_t workerIndex) override;
+
+  [[nodiscard]] std::size_t getNumEvents() const;
+  /** Writes recorded events as a JSON object. */
+  void write(std::ostream &) const;
+  void clear();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Event {
+    std::string_view name; // Of a pass (see Worker::names).
+    Phase phase;           // Unless isPass.
+    bool isPass;
+    char type; // 'B' = begin, 'E' = end.
+    Clock::time_point timestamp;
+  };
+  // Written by a single thread, apart from other ones (cache line).
+  struct alignas(64) Worker {
+    NameTable names; // Copies of pass names, they outlive the FrameGraph.
+    std::vector<Event> events;
+  };
+  void _record(const PassNode *, Phase, char type, uint32_t workerIndex);
+
+private:
+  const Clock::time_point m_start;
+  std::vector<Worker> m_workers;
+};
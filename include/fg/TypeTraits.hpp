@@ -1,6 +1,17 @@
 #pragma once
 
 #include <string_view>
+#include <functional>
+#include <cstdint>
+
+// Unique (per type) address, an alternative to RTTI.
+using TypeId = const void *;
+template <typename T> struct TypeIdHolder {
+  static constexpr char id{};
+};
+template <typename T> [[nodiscard]] constexpr TypeId typeId() {
+  return &TypeIdHolder<T>::id;
+}
 
 // https://www.bfilipek.com/2016/02/notes-on-c-sfinae.html
 
@@ -28,11 +39,43 @@ template <typename T>
 concept has_preWrite = requires(T t) {
   { t.preWrite(typename T::Desc{}, 0u, (void *)nullptr) } -> std::same_as<void>;
 };
+// Split barrier, begin and end halves of a transition between two states
+// (flags of accesses).
+template <typename T>
+concept has_splitTransitions = requires(T t) {
+  {
+    t.beginTransition(typename T::Desc{}, 0u, 0u, (void *)nullptr)
+  } -> std::same_as<void>;
+  {
+    t.endTransition(typename T::Desc{}, 0u, 0u, (void *)nullptr)
+  } -> std::same_as<void>;
+};
 
 template <typename T>
 concept has_toString = requires() {
   { T::toString(typename T::Desc{}) } -> std::convertible_to<std::string_view>;
 };
+
+template <typename T>
+concept has_hash = requires(const T &v) {
+  { std::hash<T>{}(v) } -> std::convertible_to<std::size_t>;
+};
+template <typename T>
+concept has_equality = std::equality_comparable<T>;
+
+// Transient that can be placed in a heap shared with other transients.
+template <typename T>
+concept has_memoryRequirements = requires(T t) {
+  {
+    T::memoryRequirements(typename T::Desc{}).size
+  } -> std::convertible_to<uint64_t>;
+  {
+    T::memoryRequirements(typename T::Desc{}).alignment
+  } -> std::convertible_to<uint64_t>;
+  {
+    t.create(typename T::Desc{}, (void *)nullptr, uint64_t{})
+  } -> std::same_as<void>;
+};
 #else
 // https://en.cppreference.com/w/cpp/types/enable_if
 // https://levelup.gitconnected.com/c-detection-idiom-explained-5cc7207a0067
@@ -70,6 +113,12 @@ inline constexpr bool is_resource =
 
 DETECT_FUNCTION(preRead, typename T::Desc{}, 0u, (void *)nullptr)
 DETECT_FUNCTION(preWrite, typename T::Desc{}, 0u, (void *)nullptr)
+DETECT_FUNCTION(beginTransition, typename T::Desc{}, 0u, 0u, (void *)nullptr)
+DETECT_FUNCTION(endTransition, typename T::Desc{}, 0u, 0u, (void *)nullptr)
+
+template <typename T>
+inline constexpr bool has_splitTransitions =
+  has_beginTransition<T>::value && has_endTransition<T>::value;
 
 #  undef DETECT_FUNCTION
 
@@ -79,4 +128,30 @@ struct has_toString<T, std::void_t<decltype(T::toString)>>
     : std::is_convertible<decltype(T::toString(typename T::Desc{})),
                           std::string_view> {};
 
+template <typename T, typename = void> struct has_hash : std::false_type {};
+template <typename T>
+struct has_hash<T, std::void_t<decltype(std::hash<T>{}(std::declval<T>()))>>
+    : std::is_convertible<decltype(std::hash<T>{}(std::declval<T>())),
+                          std::size_t> {};
+
+template <typename T, typename = void>
+struct has_equality : std::false_type {};
+template <typename T>
+struct has_equality<T, std::void_t<decltype(std::declval<const T &>() ==
+                                            std::declval<const T &>())>>
+    : std::is_convertible<decltype(std::declval<const T &>() ==
+                                   std::declval<const T &>()),
+                          bool> {};
+
+template <typename T, typename = void>
+struct has_memoryRequirements : std::false_type {};
+template <typename T>
+struct has_memoryRequirements<
+  T,
+  std::void_t<decltype(T::memoryRequirements(typename T::Desc{}).size),
+              decltype(T::memoryRequirements(typename T::Desc{}).alignment),
+              decltype(std::declval<T &>().create(
+                typename T::Desc{}, (void *)nullptr, uint64_t{}))>>
+    : std::true_type {};
+
 #endif
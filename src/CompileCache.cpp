@@ -0,0 +1,47 @@
+#include "fg/CompileCache.hpp"
+#include <algorithm>
+#include <cassert>
+
+FrameGraphCompileCache::FrameGraphCompileCache(uint32_t capacity)
+    : m_capacity{capacity} {
+  assert(capacity > 0);
+  m_entries.reserve(capacity);
+}
+
+void FrameGraphCompileCache::clear() {
+  m_entries.clear();
+  m_numHits = 0;
+  m_numMisses = 0;
+}
+
+//
+// (private):
+//
+
+const FrameGraphCompileCache::CompiledGraph *
+FrameGraphCompileCache::_find(const Key &key, const Settings &settings) {
+  ++m_numCompilations;
+  for (auto &entry : m_entries) {
+    if (entry.key.hash == key.hash && entry.settings == settings &&
+        entry.key.words == key.words) {
+      entry.lastUsed = m_numCompilations;
+      ++m_numHits;
+      return &entry.graph;
+    }
+  }
+  ++m_numMisses;
+  return nullptr;
+}
+FrameGraphCompileCache::CompiledGraph &
+FrameGraphCompileCache::_insert(const Key &key, const Settings &settings) {
+  auto &entry = m_entries.size() < m_capacity
+                  ? m_entries.emplace_back()
+                  : *std::min_element(m_entries.begin(), m_entries.end(),
+                                      [](const auto &a, const auto &b) {
+                                        return a.lastUsed < b.lastUsed;
+                                      });
+  entry.key = key;
+  entry.settings = settings;
+  entry.lastUsed = m_numCompilations;
+  return entry.graph;
+}
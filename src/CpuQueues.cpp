@@ -0,0 +1,56 @@
+#include "fg/CpuQueues.hpp"
+#include <thread>
+
+namespace {
+
+[[nodiscard]] auto toIndex(FrameGraphQueue queue) {
+  return static_cast<uint32_t>(queue);
+}
+
+} // namespace
+
+void *FrameGraphCpuQueues::getContext(FrameGraphQueue queue) {
+  return &m_commandLists[toIndex(queue)];
+}
+void FrameGraphCpuQueues::signal(FrameGraphQueue queue, uint32_t value) {
+  m_commandLists[toIndex(queue)].record([this, queue, value] {
+    {
+      std::lock_guard lock{m_mutex};
+      m_timelines[toIndex(queue)] = value;
+    }
+    m_signaled.notify_all();
+  });
+}
+void FrameGraphCpuQueues::wait(FrameGraphQueue queue, FrameGraphQueue signaled,
+                               uint32_t value) {
+  m_commandLists[toIndex(queue)].record([this, signaled, value] {
+    std::unique_lock lock{m_mutex};
+    ++m_numWaits;
+    m_signaled.wait(lock, [this, signaled, value] {
+      return m_timelines[toIndex(signaled)] >= value;
+    });
+  });
+}
+
+void FrameGraphCpuQueues::submit() {
+  m_timelines = {};
+  m_numWaits = 0;
+  std::vector<std::thread> threads;
+  for (auto i = 0u; i < kNumQueues; ++i) {
+    if (!m_commandLists[i].m_commands.empty())
+      threads.emplace_back(&FrameGraphCpuQueues::_run, this, i);
+  }
+  for (auto &thread : threads)
+    thread.join();
+}
+
+//
+// (private):
+//
+
+void FrameGraphCpuQueues::_run(uint32_t queueIndex) {
+  auto &commands = m_commandLists[queueIndex].m_commands;
+  for (const auto &command : commands)
+    command();
+  commands.clear();
+}
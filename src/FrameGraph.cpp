@@ -1,105 +1,1339 @@
 #include "fg/FrameGraph.hpp"
+#include "fg/CompileCache.hpp"
+#include "fg/JobSystem.hpp"
 #include "fg/GraphvizWriter.hpp"
-#include <stack>
+#include "fg/Instrumentation.hpp"
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef FG_ENABLE_INSTRUMENTATION
+#  define FG_INSTRUMENT(fg, call)                                              \
+    do {                                                                       \
+      if (auto *instrumentation = (fg).m_instrumentation; instrumentation)     \
+        instrumentation->call;                                                 \
+    } while (false)
+#else
+#  define FG_INSTRUMENT(fg, call)                                              \
+    do {                                                                       \
+    } while (false)
+#endif
+
+using Phase = FrameGraphInstrumentation::Phase;
+
+namespace {
+
+constexpr auto kInvalidId = ~0u;
+
+// Records of FrameGraph::m_compileKey (of different lengths) begin with a word
+// that has one in the low bits.
+constexpr uint32_t kEntryRecord{0}; // Followed by its ResourceNode.
+constexpr uint32_t kCloneRecord{1};
+constexpr uint32_t kNodeRecord{2};
+constexpr uint32_t kPassRecord{3};
+constexpr uint32_t kRecordBits{2};
+
+[[nodiscard]] uint64_t alignUp(uint64_t offset, uint64_t alignment) {
+  assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+template <typename T>
+void ensureCapacity(std::unique_ptr<T[]> &storage, uint32_t &capacity,
+                    uint32_t size) {
+  if (size > capacity) {
+    storage = std::make_unique<T[]>(size);
+    capacity = size;
+  }
+}
+
+} // namespace
+
+struct FrameGraph::ParallelExecution {
+  ParallelExecution(FrameGraph &fg, FrameGraphJobSystem &jobSystem_,
+                    void *const *contexts_, void *allocator_)
+      : frameGraph{fg}, jobSystem{jobSystem_}, contexts{contexts_},
+        allocator{allocator_} {}
+
+  FrameGraph &frameGraph;
+  FrameGraphJobSystem &jobSystem;
+  void *const *contexts;
+  void *allocator;
+  std::mutex allocatorMutex;
+
+  std::atomic<uint32_t> numRemainingJobs{0};
+  std::mutex mutex;
+  std::condition_variable done;
+  bool finished{false}; // Guarded by mutex.
+};
 
 //
 // FrameGraph class:
 //
 
+FrameGraph::FrameGraph()
+    : m_ownArena{std::in_place}, m_arena{&*m_ownArena} {}
+FrameGraph::FrameGraph(LinearAllocator &arena) : m_arena{&arena} {}
+
 void FrameGraph::reserve(uint32_t numPasses, uint32_t numResources) {
   m_passNodes.reserve(numPasses);
   m_resourceNodes.reserve(numResources);
   m_resourceRegistry.reserve(numResources);
 }
 
+void FrameGraph::reset() {
+  // Names of a frame are at most one per node, a table twice as large is
+  // mostly stale.
+  const auto numNodes = m_passNodes.size() + m_resourceNodes.size();
+  _recycleNodes();
+  if (m_names.size() > 2 * numNodes) m_names.clear();
+  // After the merged passes and resources, their payload is in arenas of
+  // recorders.
+  for (auto i = 0u; i < m_numRecorders; ++i)
+    m_recorders[i]->m_graph.reset();
+  m_numRecorders = 0;
+  m_numMerged = 0;
+
+  if (m_ownArena) m_ownArena->reset();
+}
+
 bool FrameGraph::isValid(FrameGraphResource id) const {
+  if (_isForeign(id)) return m_parent->isValid(id);
   const auto &node = _getResourceNode(id);
   return node.getVersion() == _getResourceEntry(node).getVersion();
 }
 
+FrameGraph::Recorder &FrameGraph::createRecorder() {
+  assert(!m_parent && m_numRecorders < kMaxRecorders);
+  if (m_numRecorders == m_recorders.size()) {
+    m_recorders.emplace_back(new Recorder{*this, m_numRecorders + 1});
+  }
+  auto &recorder = *m_recorders[m_numRecorders++];
+  recorder.m_nodeOffset = kInvalidId;
+  return recorder;
+}
+void FrameGraph::mergeRecorders() {
+  for (; m_numMerged < m_numRecorders; ++m_numMerged)
+    _merge(*m_recorders[m_numMerged]);
+}
+
 void FrameGraph::compile() {
-  for (auto &pass : m_passNodes) {
-    pass.m_refCount = static_cast<int32_t>(pass.m_writes.size());
-    for (const auto [id, _] : pass.m_reads) {
-      auto &consumed = m_resourceNodes[id];
-      consumed.m_refCount++;
+  mergeRecorders();
+  const CompileSettings settings{m_schedule, m_canMerge, m_isStateCompatible};
+  if (m_compileCache) {
+    if (const auto *compiled = m_compileCache->_find(m_compileKey, settings);
+        compiled) {
+      _restoreCompiled(*compiled);
+      return;
     }
-    for (const auto [id, _] : pass.m_writes) {
-      auto &written = m_resourceNodes[id];
-      written.m_producer = &pass;
+  }
+  _buildAccessLists();
+  _cull();
+  _buildDependencies();
+  _schedule();
+  _computeResourcesLifetime();
+  _buildResourceLists();
+  _buildTransitions();
+  _mergePasses();
+  _buildQueueStreams();
+  _buildSplitTransitions();
+  _aliasTransients();
+  if (m_compileCache)
+    _storeCompiled(m_compileCache->_insert(m_compileKey, settings));
+}
+void FrameGraph::setCompileCache(FrameGraphCompileCache *cache) {
+  assert(m_passNodes.empty() && m_resourceNodes.empty());
+  m_compileCache = cache;
+}
+void FrameGraph::setSchedule(Schedule schedule) { m_schedule = schedule; }
+void FrameGraph::setResourcePool(FrameGraphResourcePool *pool) {
+  m_resourcePool = pool;
+}
+void FrameGraph::setBarrierHandler(FlushBarriers flushBarriers) {
+  m_flushBarriers = flushBarriers;
+}
+bool FrameGraph::isSameRead(const Transition &previous,
+                            const Transition &next) {
+  return previous.access == Transition::Access::Read &&
+         next.access == Transition::Access::Read &&
+         previous.flags == next.flags;
+}
+void FrameGraph::setTransitionElision(IsStateCompatible isStateCompatible) {
+  m_isStateCompatible = isStateCompatible;
+}
+void FrameGraph::setPassMerging(CanMerge canMerge) { m_canMerge = canMerge; }
+void FrameGraph::setInstrumentation(
+  FrameGraphInstrumentation *instrumentation) {
+  m_instrumentation = instrumentation;
+}
+void FrameGraph::execute(void *context, void *allocator) {
+  _executeSerial(nullptr, context, allocator);
+}
+void FrameGraph::execute(FrameGraphJobSystem &jobSystem,
+                         void *const *contexts, void *allocator) {
+  ParallelExecution execution{*this, jobSystem, contexts, allocator};
+
+  const auto numPasses = static_cast<uint32_t>(m_passNodes.size());
+  ensureCapacity(m_passJobs, m_numPassJobs, numPasses);
+  const auto numResources = static_cast<uint32_t>(m_resourceRegistry.size());
+  ensureCapacity(m_pendingAccesses, m_numPendingAccesses, numResources);
+  for (auto i = 0u; i < numResources; ++i)
+    m_pendingAccesses[i].store(0, std::memory_order_relaxed);
+
+  // A merge group runs as a single job (of its first pass).
+  uint32_t numJobs{0};
+  for (const auto passId : m_executionOrder) {
+    const auto &pass = m_passNodes[passId];
+    if (m_subpasses[passId].index == 0) {
+      ++numJobs;
+      auto &job = m_passJobs[passId];
+      job.execution = &execution;
+      job.pass = &pass;
+      job.numPendingDependencies.store(0, std::memory_order_relaxed);
+    }
+
+    for (const auto &access : _getAccesses(passId)) {
+      m_pendingAccesses[access.entryId].fetch_add(1,
+                                                  std::memory_order_relaxed);
+    }
+  }
+  if (numJobs == 0) return;
+  execution.numRemainingJobs.store(numJobs);
+
+  // Dependencies inside of a merge group are implied by the order of passes.
+  for (const auto passId : m_executionOrder) {
+    const auto leaderId = _getMergeGroupLeader(passId);
+    for (const auto successorId : _getSuccessors(passId)) {
+      if (const auto id = _getMergeGroupLeader(successorId); id != leaderId) {
+        m_passJobs[id].numPendingDependencies.fetch_add(
+          1, std::memory_order_relaxed);
+      }
+    }
+  }
+  // Gathered first, submitted jobs modify the counters.
+  m_readyPasses.clear();
+  for (const auto passId : m_executionOrder) {
+    if (m_subpasses[passId].index == 0 &&
+        m_passJobs[passId].numPendingDependencies.load(
+          std::memory_order_relaxed) == 0) {
+      m_readyPasses.emplace_back(passId);
     }
   }
+  for (const auto passId : m_readyPasses)
+    jobSystem.submit({&FrameGraph::_executeJob, &m_passJobs[passId]});
+
+  std::unique_lock lock{execution.mutex};
+  execution.done.wait(lock, [&execution] { return execution.finished; });
+}
+void FrameGraph::execute(FrameGraphQueueSystem &queues, void *allocator) {
+  _executeSerial(&queues, nullptr, allocator);
+}
 
-  // -- Culling:
+//
+// (private):
+//
+
+void FrameGraph::_buildAccessLists() {
+  const auto numPasses = m_passNodes.size();
+  const auto numNodes = m_resourceNodes.size();
+
+  m_accesses.clear();
+  m_accessRanges.resize(numPasses);
+  m_producers.assign(numNodes, kInvalidId);
+  m_readerOffsets.assign(numNodes + 1, 0);
+
+  const auto add = [this](FrameGraphResource id, uint32_t flags) {
+    const auto &node = _getResourceNode(id);
+    m_accesses.push_back({node.getId(), node.getResourceId(), flags});
+  };
+  const auto offset = [this] {
+    return static_cast<uint32_t>(m_accesses.size());
+  };
+  for (const auto &pass : m_passNodes) {
+    auto &ranges = m_accessRanges[pass.getId()];
+    ranges.creates = offset();
+    for (const auto id : pass.m_creates)
+      add(id, kFlagsIgnored);
+    ranges.reads = offset();
+    for (const auto [id, flags] : pass.m_reads) {
+      add(id, flags);
+      ++m_readerOffsets[id + 1];
+    }
+    ranges.writes = offset();
+    for (const auto [id, flags] : pass.m_writes) {
+      add(id, flags);
+      m_producers[id] = pass.getId();
+    }
+    ranges.end = offset();
+  }
+
+  // Counting sort of reads by ResourceNode.
+  for (std::size_t i{1}; i <= numNodes; ++i)
+    m_readerOffsets[i] += m_readerOffsets[i - 1];
+  m_readers.resize(m_readerOffsets.back());
+  m_cursors.assign(m_readerOffsets.begin(), m_readerOffsets.end() - 1);
+  for (const auto &pass : m_passNodes) {
+    for (const auto &access : _getReads(pass.getId()))
+      m_readers[m_cursors[access.nodeId]++] = pass.getId();
+  }
+}
+void FrameGraph::_cull() {
+  for (auto &node : m_resourceNodes)
+    node.m_refCount = static_cast<int32_t>(_getReaders(node.getId()).size());
+  for (auto &pass : m_passNodes)
+    pass.m_refCount = static_cast<int32_t>(_getWrites(pass.getId()).size());
 
-  std::stack<ResourceNode *> unreferencedResources;
-  for (auto &node : m_resourceNodes) {
-    if (node.m_refCount == 0) unreferencedResources.push(&node);
+  auto &unreferencedResources = m_unreferencedResources;
+  unreferencedResources.clear();
+  for (const auto &node : m_resourceNodes) {
+    if (node.m_refCount == 0) unreferencedResources.push_back(node.getId());
   }
   while (!unreferencedResources.empty()) {
-    auto *unreferencedResource = unreferencedResources.top();
-    unreferencedResources.pop();
-    PassNode *producer{unreferencedResource->m_producer};
-    if (producer == nullptr || producer->hasSideEffect()) continue;
+    const auto producerId = m_producers[unreferencedResources.back()];
+    unreferencedResources.pop_back();
+    if (producerId == kInvalidId) continue;
 
-    assert(producer->m_refCount >= 1);
-    if (--producer->m_refCount == 0) {
-      for (const auto [id, _] : producer->m_reads) {
-        auto &node = m_resourceNodes[id];
-        if (--node.m_refCount == 0) unreferencedResources.push(&node);
+    auto &producer = m_passNodes[producerId];
+    if (producer.hasSideEffect()) continue;
+
+    assert(producer.m_refCount >= 1);
+    if (--producer.m_refCount == 0) {
+      for (const auto &access : _getReads(producerId)) {
+        auto &node = m_resourceNodes[access.nodeId];
+        if (--node.m_refCount == 0)
+          unreferencedResources.push_back(node.getId());
       }
     }
   }
+}
+void FrameGraph::_computeResourcesLifetime() {
+  for (auto &entry : m_resourceRegistry) {
+    entry.m_producer = kInvalidId;
+    entry.m_last = kInvalidId;
+  }
+  for (const auto passId : m_executionOrder) {
+    for (const auto &access : _getCreates(passId))
+      m_resourceRegistry[access.entryId].m_producer = passId;
+    for (const auto &access : _getAccesses(passId))
+      m_resourceRegistry[access.entryId].m_last = passId;
+  }
+}
+void FrameGraph::_buildResourceLists() {
+  for (auto &pass : m_passNodes) {
+    pass.m_acquires.clear();
+    pass.m_releases.clear();
+  }
+  for (const auto &entry : m_resourceRegistry) {
+    if (!entry.isTransient() || entry.m_producer == kInvalidId) continue;
+
+    m_passNodes[entry.m_producer].m_acquires.emplace_back(entry.getId());
+    m_passNodes[entry.m_last].m_releases.emplace_back(entry.getId());
+  }
+}
 
-  // -- Calculate resources lifetime:
+void FrameGraph::_buildDependencies() {
+  const auto numPasses = m_passNodes.size();
 
-  for (auto &pass : m_passNodes) {
-    if (pass.m_refCount == 0) continue;
+  m_edges.clear();
+  m_edgeStamps.assign(numPasses, kInvalidId);
+  m_writeStamps.assign(m_resourceRegistry.size(), kInvalidId);
+  m_numPredecessors.assign(numPasses, 0);
 
-    for (const auto id : pass.m_creates)
-      _getResourceEntry(id).m_producer = &pass;
-    for (const auto [id, _] : pass.m_writes)
-      _getResourceEntry(id).m_last = &pass;
-    for (const auto [id, _] : pass.m_reads)
-      _getResourceEntry(id).m_last = &pass;
+  const auto addEdge = [this](uint32_t from, uint32_t to) {
+    if (from == kInvalidId || from == to || m_edgeStamps[from] == to ||
+        !m_passNodes[from].canExecute()) {
+      return;
+    }
+    m_edgeStamps[from] = to;
+    m_edges.push_back({from, to});
+    ++m_numPredecessors[to];
+  };
+
+  // Each version of a resource (ResourceNode) has a single producer, a writer
+  // of the next version reads the previous one. Hence:
+  // - read after write: a reader waits for the producer,
+  // - write after read/write: a writer waits for readers of the previous
+  //   version (and its producer, as one of them).
+  for (const auto &pass : m_passNodes) {
+    if (!pass.canExecute()) continue;
+
+    const auto passId = pass.getId();
+    for (const auto &access : _getWrites(passId))
+      m_writeStamps[access.entryId] = passId;
+    for (const auto &access : _getReads(passId)) {
+      addEdge(m_producers[access.nodeId], passId);
+      if (m_writeStamps[access.entryId] == passId) {
+        for (const auto readerId : _getReaders(access.nodeId))
+          addEdge(readerId, passId);
+      }
+    }
   }
+  _buildSuccessors();
 }
-void FrameGraph::execute(void *context, void *allocator) {
+void FrameGraph::_buildSuccessors() {
+  const auto numPasses = m_passNodes.size();
+  // Counting sort of edges by the source.
+  m_successorOffsets.assign(numPasses + 1, 0);
+  for (const auto [from, _] : m_edges)
+    ++m_successorOffsets[from + 1];
+  for (std::size_t i{1}; i <= numPasses; ++i)
+    m_successorOffsets[i] += m_successorOffsets[i - 1];
+  m_successors.resize(m_edges.size());
+  m_cursors.assign(m_successorOffsets.begin(), m_successorOffsets.end() - 1);
+  for (const auto [from, to] : m_edges)
+    m_successors[m_cursors[from]++] = to;
+}
+void FrameGraph::_schedule() {
+  m_executionOrder.clear();
+  if (m_schedule == Schedule::DeclarationOrder) {
+    // Dependencies always point forward, the order is already topological.
+    for (const auto &pass : m_passNodes) {
+      if (pass.canExecute()) m_executionOrder.emplace_back(pass.getId());
+    }
+    return;
+  }
+
+  const auto numPasses = m_passNodes.size();
+  const auto numResources = m_resourceRegistry.size();
+  const auto minimizeMemory = m_schedule == Schedule::MinimizeMemory;
+  m_numPendingPredecessors.resize(numPasses);
+  m_nextSideEffects.assign(numPasses, kInvalidId);
+  m_costStamps.assign(numPasses, 0);
+  m_remainingAccesses.assign(numResources, 0);
+  m_readyPasses.clear();
+  m_readyHeap.clear();
+
+  // Passes with side-effect are chained, as if each one depended on the
+  // previous one.
+  auto lastSideEffect = kInvalidId;
   for (const auto &pass : m_passNodes) {
     if (!pass.canExecute()) continue;
 
-    for (const auto id : pass.m_creates)
-      _getResourceEntry(id).create(allocator);
+    const auto id = pass.getId();
+    m_numPendingPredecessors[id] = m_numPredecessors[id];
+    if (pass.hasSideEffect()) {
+      if (lastSideEffect != kInvalidId) {
+        m_nextSideEffects[lastSideEffect] = id;
+        ++m_numPendingPredecessors[id];
+      }
+      lastSideEffect = id;
+    }
+    if (m_numPendingPredecessors[id] == 0) m_readyPasses.emplace_back(id);
+    for (const auto &access : _getAccesses(id))
+      ++m_remainingAccesses[access.entryId];
+  }
 
-    for (const auto [id, flags] : pass.m_reads) {
-      if (flags != kFlagsIgnored) _getResourceEntry(id).preRead(flags, context);
+  // The cost of a ready pass (MinimizeMemory) changes only once it becomes the
+  // last one to access a resource. Passes that access a resource are counted
+  // (and sorted) to find it.
+  if (minimizeMemory) {
+    m_accessStamps.assign(numResources, kInvalidId);
+    m_accessingPassOffsets.assign(numResources + 1, 0);
+    const auto eachAccessedEntry = [this](uint32_t passId, auto &&f) {
+      for (const auto &access : _getAccesses(passId)) {
+        if (m_accessStamps[access.entryId] == passId) continue;
+        m_accessStamps[access.entryId] = passId;
+        f(access.entryId);
+      }
+    };
+    for (const auto &pass : m_passNodes) {
+      if (pass.canExecute()) {
+        eachAccessedEntry(pass.getId(), [this](uint32_t entryId) {
+          ++m_accessingPassOffsets[entryId + 1];
+        });
+      }
     }
-    for (const auto [id, flags] : pass.m_writes) {
-      if (flags != kFlagsIgnored)
-        _getResourceEntry(id).preWrite(flags, context);
+    m_remainingPasses.resize(numResources);
+    for (std::size_t i{0}; i < numResources; ++i) {
+      m_remainingPasses[i] = m_accessingPassOffsets[i + 1];
+      m_accessingPassOffsets[i + 1] += m_accessingPassOffsets[i];
+    }
+    m_accessingPasses.resize(m_accessingPassOffsets.back());
+    m_cursors.assign(m_accessingPassOffsets.begin(),
+                     m_accessingPassOffsets.end() - 1);
+    m_accessStamps.assign(numResources, kInvalidId);
+    for (const auto &pass : m_passNodes) {
+      if (pass.canExecute()) {
+        eachAccessedEntry(pass.getId(), [this, &pass](uint32_t entryId) {
+          m_accessingPasses[m_cursors[entryId]++] = pass.getId();
+        });
+      }
+    }
+    m_accessStamps.assign(numResources, kInvalidId);
+  }
+
+  // Change of size (then count) of live transients, after the pass.
+  const auto evaluate = [this](uint32_t passId, ReadyPass &cost) {
+    const auto account = [this, &cost](uint32_t resourceId, int64_t sign) {
+      const auto &entry = m_resourceRegistry[resourceId];
+      if (!entry.isTransient()) return;
+      cost.primary += sign * int64_t(entry.getMemoryRequirements().size);
+      cost.secondary += sign;
+    };
+    for (const auto &access : _getCreates(passId))
+      account(access.entryId, 1);
+    const auto accesses = _getAccesses(passId);
+    for (const auto &access : accesses) {
+      if (--m_remainingAccesses[access.entryId] == 0)
+        account(access.entryId, -1);
     }
-    FrameGraphPassResources resources{*this, pass};
-    std::invoke(*pass.m_exec, resources, context);
+    for (const auto &access : accesses)
+      ++m_remainingAccesses[access.entryId];
+  };
+  // Min-heap, lower cost is better, ties are resolved by declaration order.
+  // An entry is stale once the pass is scheduled or evaluated again.
+  const auto isWorse = [](const ReadyPass &lhs, const ReadyPass &rhs) {
+    return lhs.primary != rhs.primary       ? lhs.primary > rhs.primary
+           : lhs.secondary != rhs.secondary ? lhs.secondary > rhs.secondary
+                                            : lhs.passId > rhs.passId;
+  };
+  const auto push = [this, minimizeMemory, &evaluate, &isWorse](uint32_t id) {
+    ReadyPass ready{0, 0, id, ++m_costStamps[id]};
+    if (minimizeMemory) {
+      evaluate(id, ready);
+    } else {
+      // MaximizeDistance, the earliest one to become ready.
+      ready.primary = static_cast<int64_t>(m_executionOrder.size());
+    }
+    m_readyHeap.push_back(ready);
+    std::push_heap(m_readyHeap.begin(), m_readyHeap.end(), isWorse);
+  };
+  const auto release = [this, &push](uint32_t id) {
+    if (--m_numPendingPredecessors[id] == 0) push(id);
+  };
+  for (const auto id : m_readyPasses)
+    push(id);
+  while (!m_readyHeap.empty()) {
+    std::pop_heap(m_readyHeap.begin(), m_readyHeap.end(), isWorse);
+    const auto [primary, secondary, passId, stamp] = m_readyHeap.back();
+    m_readyHeap.pop_back();
+    if (stamp != m_costStamps[passId]) continue;
+
+    m_costStamps[passId] = kScheduled;
+    m_executionOrder.emplace_back(passId);
+    const auto accesses = _getAccesses(passId);
+    for (const auto &access : accesses)
+      --m_remainingAccesses[access.entryId];
+    if (minimizeMemory) {
+      for (const auto &access : accesses) {
+        const auto entryId = access.entryId;
+        if (m_accessStamps[entryId] == passId) continue;
+        m_accessStamps[entryId] = passId;
+        if (--m_remainingPasses[entryId] != 1) continue;
 
-    for (auto &entry : m_resourceRegistry) {
-      if (entry.m_last == &pass && entry.isTransient())
-        entry.destroy(allocator);
+        for (auto i = m_accessingPassOffsets[entryId];
+             i < m_accessingPassOffsets[entryId + 1]; ++i) {
+          const auto id = m_accessingPasses[i];
+          if (m_costStamps[id] != kScheduled &&
+              m_numPendingPredecessors[id] == 0) {
+            push(id);
+          }
+        }
+      }
     }
+    for (const auto id : _getSuccessors(passId))
+      release(id);
+    if (const auto id = m_nextSideEffects[passId]; id != kInvalidId)
+      release(id);
   }
+  assert(std::size_t(std::count_if(
+           m_passNodes.cbegin(), m_passNodes.cend(),
+           [](const auto &pass) { return pass.canExecute(); })) ==
+         m_executionOrder.size());
 }
+void FrameGraph::_buildTransitions() {
+  m_transitions.clear();
+  m_transitionRanges.assign(m_passNodes.size(), {});
+  m_resourceStates.assign(m_resourceRegistry.size(),
+                          {{nullptr, 0, Transition::Access::Read}, kInvalidId});
+  m_transitionStats = {};
 
-//
-// (private):
-//
+  for (const auto passId : m_executionOrder) {
+    const auto &pass = m_passNodes[passId];
+    auto &range = m_transitionRanges[passId];
+    range.first = static_cast<uint32_t>(m_transitions.size());
+    m_unorderedTransitions.clear();
+    const auto emit = [this, &pass](const Access &access,
+                                    Transition::Access type) {
+      auto &state = m_resourceStates[access.entryId];
+      if (access.flags == static_cast<uint32_t>(kFlagsIgnored)) {
+        // The resource is modified in an unknown state, the next access
+        // can't rely on the tracked one.
+        if (type == Transition::Access::Write) state.passId = kInvalidId;
+        return;
+      }
+
+      ++m_transitionStats.numTransitions;
+      auto &entry = m_resourceRegistry[access.entryId];
+      const Transition next{&entry, access.flags, type};
+      if (m_isStateCompatible && state.passId != kInvalidId &&
+          m_isStateCompatible(state.transition, next)) {
+        ++m_transitionStats.numElided;
+        if (state.transition.access == Transition::Access::Read &&
+            type == Transition::Access::Read && state.passId != pass.getId()) {
+          m_unorderedTransitions.push_back(next);
+        }
+        return;
+      }
+      m_transitions.push_back(next);
+      state = {next, pass.getId()};
+    };
+    for (const auto &access : _getReads(passId))
+      emit(access, Transition::Access::Read);
+    for (const auto &access : _getWrites(passId))
+      emit(access, Transition::Access::Write);
+
+    range.count = static_cast<uint32_t>(m_transitions.size()) - range.first;
+    range.numUnordered = static_cast<uint32_t>(m_unorderedTransitions.size());
+    m_transitions.insert(m_transitions.end(), m_unorderedTransitions.begin(),
+                         m_unorderedTransitions.end());
+  }
+}
+void FrameGraph::_mergePasses() {
+  m_mergeGroups.clear();
+  m_subpasses.assign(m_passNodes.size(), {kInvalidId, 0, 1});
+
+  const auto canMerge = [this](uint32_t prevId, uint32_t nextId) {
+    // Subpasses are recorded on the same queue.
+    if (m_passNodes[prevId].getQueue() != m_passNodes[nextId].getQueue())
+      return false;
+    constexpr auto kIgnored = static_cast<uint32_t>(kFlagsIgnored);
+    for (const auto &write : _getWrites(prevId)) {
+      if (write.flags == kIgnored) continue;
+
+      auto &entry = m_resourceRegistry[write.entryId];
+      for (const auto &read : _getReads(nextId)) {
+        if (read.flags == kIgnored || read.entryId != write.entryId) continue;
+        if (m_canMerge({&entry, write.flags, Transition::Access::Write},
+                       {&entry, read.flags, Transition::Access::Read})) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+
+  const auto numPasses = static_cast<uint32_t>(m_executionOrder.size());
+  for (auto i = 0u; i < numPasses; ++i) {
+    auto &subpass = m_subpasses[m_executionOrder[i]];
+    if (i > 0 && m_canMerge &&
+        canMerge(m_executionOrder[i - 1], m_executionOrder[i])) {
+      const auto &prev = m_subpasses[m_executionOrder[i - 1]];
+      if (prev.count == 1) m_mergeGroups.push_back({prev.first, 1});
+      ++m_mergeGroups.back().count;
+      subpass = {prev.first, prev.index + 1, 0};
+    } else {
+      subpass = {i, 0, 1};
+    }
+  }
+  for (const auto [first, count] : m_mergeGroups) {
+    for (auto i = first; i < first + count; ++i)
+      m_subpasses[m_executionOrder[i]].count = count;
+  }
+}
+void FrameGraph::_buildQueueStreams() {
+  const auto numPasses = m_passNodes.size();
+  const auto queueOf = [this](uint32_t passId) {
+    return static_cast<uint32_t>(m_passNodes[passId].getQueue());
+  };
+
+  for (auto &stream : m_queueStreams)
+    stream.clear();
+  m_streamPositions.resize(numPasses);
+  for (const auto passId : m_executionOrder) {
+    auto &stream = m_queueStreams[queueOf(passId)];
+    m_streamPositions[passId] = static_cast<uint32_t>(stream.size());
+    stream.push_back(passId);
+  }
+  m_syncPoints.clear();
+  m_signalValues.assign(numPasses, 0);
+  m_passClocks.clear();
+  const auto numQueues =
+    std::count_if(m_queueStreams.cbegin(), m_queueStreams.cend(),
+                  [](const auto &stream) { return !stream.empty(); });
+  if (numQueues < 2) return;
+
+  // A queue executes its passes in order, so a pass waits only for the last
+  // predecessor on another queue, unless a wait covers it already (an earlier
+  // one of the queue, or for a pass that has waited for it).
+  m_passClocks.resize(numPasses);
+  std::array<uint32_t, kNumQueues> noPredecessors;
+  noPredecessors.fill(kInvalidId);
+  m_lastPredecessors.assign(numPasses, noPredecessors);
+  std::array<QueueClock, kNumQueues> queueClocks{};
+  for (const auto passId : m_executionOrder) {
+    const auto queue = queueOf(passId);
+    auto &clock = queueClocks[queue];
+
+    auto signalPassIds = noPredecessors;
+    std::array<QueueClock, kNumQueues> signalClocks{}; // After the signal.
+    for (auto other = 0u; other < kNumQueues; ++other) {
+      const auto predecessorId = m_lastPredecessors[passId][other];
+      if (predecessorId == kInvalidId ||
+          m_streamPositions[predecessorId] < clock[other]) {
+        continue;
+      }
+      // Signaled after the merge group, waited for before the own one.
+      const auto &group = m_subpasses[predecessorId];
+      signalPassIds[other] = m_executionOrder[group.first + group.count - 1];
+      signalClocks[other] = m_passClocks[signalPassIds[other]];
+      signalClocks[other][other] =
+        m_streamPositions[signalPassIds[other]] + 1;
+    }
+    const auto isCovered = [&](uint32_t other) {
+      const auto predecessorId = m_lastPredecessors[passId][other];
+      const auto position = m_streamPositions[predecessorId];
+      for (auto i = 0u; i < kNumQueues; ++i) {
+        if (i != other && signalPassIds[i] != kInvalidId &&
+            signalClocks[i][other] > position) {
+          return true;
+        }
+      }
+      return false;
+    };
+    for (auto other = 0u; other < kNumQueues; ++other) {
+      if (signalPassIds[other] == kInvalidId || isCovered(other)) continue;
+
+      const auto value = signalClocks[other][other];
+      m_syncPoints.push_back(
+        {signalPassIds[other], _getMergeGroupLeader(passId), value});
+      m_signalValues[signalPassIds[other]] = value;
+      for (auto i = 0u; i < kNumQueues; ++i)
+        clock[i] = std::max(clock[i], signalClocks[other][i]);
+    }
+    m_passClocks[passId] = clock;
+    clock[queue] = m_streamPositions[passId] + 1;
+
+    for (const auto successorId : _getSuccessors(passId)) {
+      if (queueOf(successorId) != queue)
+        m_lastPredecessors[successorId][queue] = passId;
+    }
+  }
+}
+void FrameGraph::_buildSplitTransitions() {
+  const auto numPasses = m_passNodes.size();
+  m_splitTransitions.clear();
+  m_splitRanges.assign(numPasses, {});
+  m_lastAccesses.assign(
+    m_resourceRegistry.size(),
+    {kInvalidId, static_cast<uint32_t>(kFlagsIgnored), kInvalidId});
+  m_writeStamps.assign(m_resourceRegistry.size(), kInvalidId);
+  m_splitBeginOffsets.assign(numPasses + 1, 0);
+
+  // The parallel execute() runs the begin half after the previous pass and
+  // the end one before the next pass, so the latter has to depend on the
+  // former. It does, unless both only read the same version of a resource
+  // (see _buildDependencies()).
+  const auto isOrdered = [this](const LastAccess &last, uint32_t entryId,
+                                uint32_t nextId) {
+    return last.nodeId == kInvalidId || m_writeStamps[entryId] == nextId ||
+           !m_passNodes[nextId].reads(
+             static_cast<FrameGraphResource>(last.nodeId));
+  };
+  // Barriers can't be split across queues nor within a render pass.
+  const auto canSplit = [this](uint32_t previousId, uint32_t nextId) {
+    return previousId != kInvalidId && previousId != nextId &&
+           m_subpasses[previousId].first != m_subpasses[nextId].first &&
+           m_passNodes[previousId].getQueue() ==
+             m_passNodes[nextId].getQueue();
+  };
+  for (const auto passId : m_executionOrder) {
+    auto &range = m_splitRanges[passId];
+    range.first = static_cast<uint32_t>(m_splitTransitions.size());
+    for (const auto &access : _getWrites(passId))
+      m_writeStamps[access.entryId] = passId;
+    const auto &[first, count, _] = m_transitionRanges[passId];
+    for (auto i = first; i < first + count; ++i) {
+      const auto &[entry, flags, access] = m_transitions[i];
+      auto &last = m_lastAccesses[entry->getId()];
+      if (entry->hasSplitTransitions()) {
+        auto beginPassId = kInvalidId;
+        if (canSplit(last.passId, passId) &&
+            isOrdered(last, entry->getId(), passId)) {
+          const auto &group = m_subpasses[last.passId];
+          beginPassId = m_executionOrder[group.first + group.count - 1];
+          ++m_splitBeginOffsets[beginPassId + 1];
+          ++m_transitionStats.numSplit;
+        }
+        m_splitTransitions.push_back({entry, last.flags, flags, beginPassId});
+      }
+      last.flags = flags;
+    }
+    range.count =
+      static_cast<uint32_t>(m_splitTransitions.size()) - range.first;
+    // Reads precede writes (and follow creates) in the access list.
+    for (const auto &access : _getAccesses(passId)) {
+      auto &last = m_lastAccesses[access.entryId];
+      last.passId = passId;
+      last.nodeId =
+        m_writeStamps[access.entryId] == passId ? kInvalidId : access.nodeId;
+    }
+  }
+
+  // Counting sort of split transitions by the pass that begins them.
+  for (std::size_t i{1}; i <= numPasses; ++i)
+    m_splitBeginOffsets[i] += m_splitBeginOffsets[i - 1];
+  m_splitBegins.resize(m_splitBeginOffsets.back());
+  m_cursors.assign(m_splitBeginOffsets.begin(), m_splitBeginOffsets.end() - 1);
+  for (auto i = 0u; i < m_splitTransitions.size(); ++i) {
+    if (const auto beginPassId = m_splitTransitions[i].beginPassId;
+        beginPassId != kInvalidId) {
+      m_splitBegins[m_cursors[beginPassId]++] = i;
+    }
+  }
+}
+void FrameGraph::_aliasTransients() {
+  // Simulates a best-fit allocator in the execution order, a resource is
+  // allocated before its first pass and freed after the last one.
+  // With multiple queues, freed memory is reused only by a pass that waits
+  // (also transitively) for all passes that have accessed it. The parallel
+  // execute() gets the same guarantee from dependencies added here.
+  auto &freeRanges = m_freeHeapRanges;
+  auto &freeSizes = m_freeHeapSizes;
+  freeRanges.clear();
+  freeSizes.clear();
+  auto &stats = m_transientMemoryStats;
+  stats = {};
+  uint64_t liveSize{0};
+
+  const auto isReusable = [](const QueueClock &released,
+                             const QueueClock &clock) {
+    for (auto i = 0u; i < kNumQueues; ++i) {
+      if (released[i] > clock[i]) return false;
+    }
+    return true;
+  };
+  const auto addRange = [&freeRanges, &freeSizes](uint64_t offset,
+                                                  uint64_t size,
+                                                  const QueueClock &released) {
+    freeSizes.emplace(size, offset);
+    freeRanges.emplace(offset, MemoryRange{size, released});
+  };
+  const auto removeRange = [&freeRanges, &freeSizes](auto it) {
+    freeSizes.erase({it->second.size, it->first});
+    return freeRanges.erase(it);
+  };
+  const auto allocate = [&](uint64_t size, uint64_t alignment,
+                            const QueueClock &clock) {
+    // Best-fit, the smallest range (the lowest one of a size) that holds the
+    // aligned resource. Smaller ranges are skipped by the lookup.
+    for (auto it = freeSizes.lower_bound({size, 0}); it != freeSizes.end();
+         ++it) {
+      const auto [rangeSize, begin] = *it;
+      const auto offset = alignUp(begin, alignment);
+      const auto end = begin + rangeSize;
+      const auto range = freeRanges.find(begin);
+      if (offset + size > end || !isReusable(range->second.released, clock))
+        continue;
+
+      const auto released = range->second.released;
+      removeRange(range);
+      if (offset + size < end)
+        addRange(offset + size, end - (offset + size), released);
+      if (offset > begin) addRange(begin, offset - begin, released);
+      return offset;
+    }
+
+    // Grow the heap, reusing the free range at its end (if any).
+    auto begin = stats.heapSize;
+    QueueClock released{};
+    if (!freeRanges.empty()) {
+      if (const auto last = std::prev(freeRanges.end());
+          last->first + last->second.size == begin &&
+          isReusable(last->second.released, clock)) {
+        begin = last->first;
+        released = last->second.released;
+        removeRange(last);
+      }
+    }
+    const auto offset = alignUp(begin, alignment);
+    if (offset > begin) addRange(begin, offset - begin, released);
+    stats.heapSize = offset + size;
+    return offset;
+  };
+  const auto release = [&freeRanges, &addRange, &removeRange](
+                         uint64_t offset, uint64_t size, QueueClock released) {
+    // Merged ranges are reusable once both are.
+    const auto merge = [&released](const MemoryRange &other) {
+      for (auto i = 0u; i < kNumQueues; ++i)
+        released[i] = std::max(released[i], other.released[i]);
+    };
+    auto next = freeRanges.lower_bound(offset);
+    if (next != freeRanges.end() && offset + size == next->first) {
+      size += next->second.size;
+      merge(next->second);
+      next = removeRange(next);
+    }
+    if (next != freeRanges.begin()) {
+      if (const auto prev = std::prev(next);
+          prev->first + prev->second.size == offset) {
+        offset = prev->first;
+        size += prev->second.size;
+        merge(prev->second);
+        removeRange(prev);
+      }
+    }
+    addRange(offset, size, released);
+  };
+
+  for (auto &entry : m_resourceRegistry)
+    entry.m_heapOffset = ResourceEntry::kInvalidHeapOffset;
+
+  // Last accesses of a resource are the producer of its last (executed)
+  // version and readers of it, earlier accesses precede them. Except for the
+  // pass that creates it, which doesn't have to write it.
+  m_lastNodes.assign(m_resourceRegistry.size(), kInvalidId);
+  for (const auto passId : m_executionOrder) {
+    for (const auto &access : _getAccesses(passId)) {
+      auto &last = m_lastNodes[access.entryId];
+      if (last == kInvalidId || access.nodeId > last) last = access.nodeId;
+    }
+  }
+  // Memory of released resources, until it's reused (accesses of a resource
+  // follow the pass that creates it, a later allocation of the reused part
+  // depends on them through that pass).
+  auto &occupants = m_heapOccupants;
+  occupants.clear();
+  const auto numEdges = m_edges.size();
+  const auto dependOn = [this](uint32_t entryId, uint32_t passId) {
+    const auto nodeId = m_lastNodes[entryId];
+    const auto creatorId = m_resourceRegistry[entryId].m_producer;
+    const auto producerId = m_producers[nodeId];
+    m_edges.push_back({creatorId, passId});
+    if (producerId != kInvalidId && producerId != creatorId)
+      m_edges.push_back({producerId, passId});
+    for (const auto readerId : _getReaders(nodeId)) {
+      if (m_passNodes[readerId].canExecute())
+        m_edges.push_back({readerId, passId});
+    }
+  };
+  const auto dependOnOccupants = [&occupants, &dependOn](uint32_t passId,
+                                                         uint64_t offset,
+                                                         uint64_t size) {
+    const auto end = offset + size;
+    auto it = occupants.lower_bound(offset);
+    if (it != occupants.begin()) {
+      if (const auto prev = std::prev(it);
+          prev->first + prev->second.size > offset) {
+        it = prev;
+      }
+    }
+    while (it != occupants.end() && it->first < end) {
+      const auto begin = it->first;
+      const auto [occupantSize, entryId] = it->second;
+      dependOn(entryId, passId);
+      // Parts that are not reused stay occupied.
+      it = occupants.erase(it);
+      if (begin < offset)
+        occupants.emplace(begin, HeapOccupant{offset - begin, entryId});
+      if (begin + occupantSize > end) {
+        occupants.emplace_hint(
+          it, end, HeapOccupant{begin + occupantSize - end, entryId});
+      }
+    }
+  };
+
+  // Accesses of a resource (stream position + 1 of the last one) on each
+  // queue. With a single queue all clocks stay zero.
+  const auto multipleQueues = !m_passClocks.empty();
+  m_entryClocks.assign(multipleQueues ? m_resourceRegistry.size() : 0, {});
+  if (multipleQueues) {
+    for (const auto passId : m_executionOrder) {
+      const auto queue = static_cast<uint32_t>(m_passNodes[passId].getQueue());
+      for (const auto &access : _getAccesses(passId))
+        m_entryClocks[access.entryId][queue] = m_streamPositions[passId] + 1;
+    }
+  }
+  constexpr QueueClock kNoClock{};
+
+  for (const auto passId : m_executionOrder) {
+    const auto &pass = m_passNodes[passId];
+    for (const auto id : pass.m_acquires) {
+      auto &entry = m_resourceRegistry[id];
+      const auto [size, alignment] = entry.getMemoryRequirements();
+      if (size == 0) continue;
+
+      entry.m_heapOffset = allocate(
+        size, alignment, multipleQueues ? m_passClocks[passId] : kNoClock);
+      dependOnOccupants(passId, entry.m_heapOffset, size);
+      stats.unaliasedSize += size;
+      liveSize += size;
+      stats.peakLiveSize = std::max(stats.peakLiveSize, liveSize);
+    }
+    for (const auto id : pass.m_releases) {
+      const auto &entry = m_resourceRegistry[id];
+      if (entry.m_heapOffset == ResourceEntry::kInvalidHeapOffset) continue;
+
+      const auto size = entry.getMemoryRequirements().size;
+      release(entry.m_heapOffset, size,
+              multipleQueues ? m_entryClocks[id] : kNoClock);
+      occupants.emplace(entry.m_heapOffset, HeapOccupant{size, id});
+      liveSize -= size;
+    }
+  }
+  if (m_edges.size() > numEdges) _buildSuccessors();
+}
+
+void FrameGraph::_executeSerial(FrameGraphQueueSystem *queues, void *context,
+                               void *allocator) {
+  auto syncPoint = m_syncPoints.cbegin();
+  for (const auto passId : m_executionOrder) {
+    const auto &pass = m_passNodes[passId];
+    FG_INSTRUMENT(*this, beginPass(pass, 0));
+    if (queues) {
+      for (; syncPoint != m_syncPoints.cend() &&
+             syncPoint->waitPassId == passId;
+           ++syncPoint) {
+        queues->wait(pass.getQueue(),
+                     m_passNodes[syncPoint->signalPassId].getQueue(),
+                     syncPoint->value);
+      }
+      context = queues->getContext(pass.getQueue());
+    }
+    if (!pass.m_acquires.empty()) {
+      FG_INSTRUMENT(*this, beginPhase(Phase::Create, pass, 0));
+      for (const auto id : pass.m_acquires)
+        m_resourceRegistry[id].create(allocator, m_resourcePool);
+      FG_INSTRUMENT(*this, endPhase(Phase::Create, pass, 0));
+    }
+    _executePass(pass, context, 0, false);
+    if (!pass.m_releases.empty()) {
+      FG_INSTRUMENT(*this, beginPhase(Phase::Destroy, pass, 0));
+      for (const auto id : pass.m_releases)
+        m_resourceRegistry[id].destroy(allocator, m_resourcePool);
+      FG_INSTRUMENT(*this, endPhase(Phase::Destroy, pass, 0));
+    }
+    if (queues && m_signalValues[passId] > 0)
+      queues->signal(pass.getQueue(), m_signalValues[passId]);
+    FG_INSTRUMENT(*this, endPass(pass, 0));
+  }
+}
+void FrameGraph::_executePass(const PassNode &pass, void *context,
+                              uint32_t workerIndex, bool parallel) {
+  const auto passId = pass.getId();
+  const auto [first, numOrdered, numUnordered] = m_transitionRanges[passId];
+  const auto count = numOrdered + (parallel ? numUnordered : 0);
+  const auto [firstSplit, numSplit] = m_splitRanges[passId];
+  if (count > 0 || numSplit > 0) {
+    FG_INSTRUMENT(*this, beginPhase(Phase::Barriers, pass, workerIndex));
+    for (auto i = firstSplit; i < firstSplit + numSplit; ++i) {
+      const auto &[entry, previousFlags, nextFlags, beginPassId] =
+        m_splitTransitions[i];
+      if (beginPassId == kInvalidId)
+        entry->beginTransition(previousFlags, nextFlags, context);
+      entry->endTransition(previousFlags, nextFlags, context);
+    }
+    if (count > 0 && m_flushBarriers) {
+      m_flushBarriers(m_transitions.data() + first, count, context);
+    } else {
+      for (auto i = first; i < first + count; ++i) {
+        const auto &[entry, flags, access] = m_transitions[i];
+        if (access == Transition::Access::Read)
+          entry->preRead(flags, context);
+        else
+          entry->preWrite(flags, context);
+      }
+    }
+    FG_INSTRUMENT(*this, endPhase(Phase::Barriers, pass, workerIndex));
+  }
+  FG_INSTRUMENT(*this, beginPhase(Phase::Execute, pass, workerIndex));
+  FrameGraphPassResources resources{*this, pass, workerIndex};
+  std::invoke(*pass.m_exec, resources, context);
+  FG_INSTRUMENT(*this, endPhase(Phase::Execute, pass, workerIndex));
+
+  const auto firstBegin = m_splitBeginOffsets[passId];
+  const auto lastBegin = m_splitBeginOffsets[passId + 1];
+  if (firstBegin < lastBegin) {
+    FG_INSTRUMENT(*this, beginPhase(Phase::Barriers, pass, workerIndex));
+    for (auto i = firstBegin; i < lastBegin; ++i) {
+      const auto &[entry, previousFlags, nextFlags, _] =
+        m_splitTransitions[m_splitBegins[i]];
+      entry->beginTransition(previousFlags, nextFlags, context);
+    }
+    FG_INSTRUMENT(*this, endPhase(Phase::Barriers, pass, workerIndex));
+  }
+}
+void FrameGraph::_executeJob(void *data, uint32_t workerIndex) {
+  auto &job = *static_cast<PassJob *>(data);
+  auto &execution = *job.execution;
+  auto &fg = execution.frameGraph;
+  const auto leaderId = job.pass->getId();
+  const auto [first, _, count] = fg.m_subpasses[leaderId];
+
+  // Readers of the same resource (version) are not ordered, the last one to
+  // finish destroys it.
+  const auto releaseAccess = [&fg, &execution](uint32_t resourceId) {
+    if (fg.m_pendingAccesses[resourceId].fetch_sub(
+          1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    auto &entry = fg.m_resourceRegistry[resourceId];
+    if (entry.isTransient() && entry.m_producer != kInvalidId) {
+      std::lock_guard lock{execution.allocatorMutex};
+      entry.destroy(execution.allocator, fg.m_resourcePool);
+    }
+  };
+  for (auto i = first; i < first + count; ++i) {
+    const auto &pass = fg.m_passNodes[fg.m_executionOrder[i]];
+    FG_INSTRUMENT(fg, beginPass(pass, workerIndex));
+    if (!pass.m_acquires.empty()) {
+      FG_INSTRUMENT(fg, beginPhase(Phase::Create, pass, workerIndex));
+      std::lock_guard lock{execution.allocatorMutex};
+      for (const auto id : pass.m_acquires)
+        fg.m_resourceRegistry[id].create(execution.allocator,
+                                         fg.m_resourcePool);
+      FG_INSTRUMENT(fg, endPhase(Phase::Create, pass, workerIndex));
+    }
+    fg._executePass(pass,
+                    execution.contexts ? execution.contexts[workerIndex]
+                                       : nullptr,
+                    workerIndex, true);
+
+    FG_INSTRUMENT(fg, beginPhase(Phase::Destroy, pass, workerIndex));
+    for (const auto &access : fg._getAccesses(pass.getId()))
+      releaseAccess(access.entryId);
+    FG_INSTRUMENT(fg, endPhase(Phase::Destroy, pass, workerIndex));
+    FG_INSTRUMENT(fg, endPass(pass, workerIndex));
+  }
+
+  for (auto i = first; i < first + count; ++i) {
+    for (const auto successorId : fg._getSuccessors(fg.m_executionOrder[i])) {
+      const auto id = fg._getMergeGroupLeader(successorId);
+      if (id == leaderId) continue;
+
+      auto &successor = fg.m_passJobs[id];
+      if (successor.numPendingDependencies.fetch_sub(
+            1, std::memory_order_acq_rel) == 1) {
+        execution.jobSystem.submit({&FrameGraph::_executeJob, &successor});
+      }
+    }
+  }
+
+  if (execution.numRemainingJobs.fetch_sub(1, std::memory_order_acq_rel) ==
+      1) {
+    std::lock_guard lock{execution.mutex};
+    execution.finished = true;
+    execution.done.notify_one();
+  }
+}
+
+void FrameGraph::_addToCompileKey(const ResourceEntry &entry) {
+  // Recorders (without a cache) add their declarations once merged.
+  if (!m_compileCache) return;
+  // Memory requirements only of aliased transients (heap offsets).
+  const auto [size, alignment] = entry.getMemoryRequirements();
+  m_compileKey.push(kEntryRecord | entry.isImported() << kRecordBits |
+                    entry.hasSplitTransitions() << (kRecordBits + 1) |
+                    (size > 0) << (kRecordBits + 2));
+  if (size > 0) {
+    const uint64_t requirements[]{size, alignment};
+    m_compileKey.append(requirements, 2);
+  }
+}
+void FrameGraph::_addToCompileKey(const ResourceNode &node, bool merged) {
+  if (!m_compileCache) return;
+  // The version of a clone follows from the previous ones.
+  if (merged) {
+    m_compileKey.push(kNodeRecord);
+    m_compileKey.push(node.getResourceId());
+    m_compileKey.push(node.getVersion());
+  } else {
+    m_compileKey.push(kCloneRecord | node.getResourceId() << kRecordBits);
+  }
+}
+void FrameGraph::_addToCompileKey(const PassNode &pass) {
+  if (!m_compileCache) return;
+  auto &key = m_compileKey;
+  key.push(kPassRecord | pass.hasSideEffect() << kRecordBits |
+           static_cast<uint32_t>(pass.getQueue()) << (kRecordBits + 1));
+  key.push(static_cast<uint32_t>(pass.m_creates.size()));
+  key.push(static_cast<uint32_t>(pass.m_reads.size()));
+  key.push(static_cast<uint32_t>(pass.m_writes.size()));
+  key.append(pass.m_creates.data(), pass.m_creates.size());
+  key.append(pass.m_reads.data(), pass.m_reads.size());
+  key.append(pass.m_writes.data(), pass.m_writes.size());
+}
+void FrameGraph::_storeCompiled(CompiledGraph &graph) const {
+  const auto numPasses = static_cast<uint32_t>(m_passNodes.size());
+  graph.refCounts.resize(numPasses + m_resourceNodes.size());
+  graph.resourceListOffsets.resize(2 * numPasses + 1);
+  graph.resourceLists.clear();
+  for (const auto &pass : m_passNodes) {
+    const auto id = pass.getId();
+    graph.refCounts[id] = pass.getRefCount();
+    auto &lists = graph.resourceLists;
+    graph.resourceListOffsets[2 * id] = static_cast<uint32_t>(lists.size());
+    lists.insert(lists.end(), pass.m_acquires.begin(), pass.m_acquires.end());
+    graph.resourceListOffsets[2 * id + 1] = static_cast<uint32_t>(lists.size());
+    lists.insert(lists.end(), pass.m_releases.begin(), pass.m_releases.end());
+  }
+  graph.resourceListOffsets.back() =
+    static_cast<uint32_t>(graph.resourceLists.size());
+  for (const auto &node : m_resourceNodes)
+    graph.refCounts[numPasses + node.getId()] = node.getRefCount();
+  graph.entries.clear();
+  for (const auto &entry : m_resourceRegistry) {
+    graph.entries.push_back(
+      {entry.m_heapOffset, entry.m_producer, entry.m_last});
+  }
+
+  graph.accesses = m_accesses;
+  graph.accessRanges = m_accessRanges;
+  graph.successorOffsets = m_successorOffsets;
+  graph.successors = m_successors;
+  graph.executionOrder = m_executionOrder;
+  graph.transientMemoryStats = m_transientMemoryStats;
+
+  graph.transitions = m_transitions;
+  graph.transitionEntryIds.clear();
+  for (const auto &transition : m_transitions)
+    graph.transitionEntryIds.push_back(transition.entry->getId());
+  graph.transitionRanges = m_transitionRanges;
+  graph.transitionStats = m_transitionStats;
+  graph.splitTransitions = m_splitTransitions;
+  graph.splitEntryIds.clear();
+  for (const auto &transition : m_splitTransitions)
+    graph.splitEntryIds.push_back(transition.entry->getId());
+  graph.splitRanges = m_splitRanges;
+  graph.splitBeginOffsets = m_splitBeginOffsets;
+  graph.splitBegins = m_splitBegins;
+
+  graph.mergeGroups = m_mergeGroups;
+  graph.subpasses = m_subpasses;
+  graph.queueStreams = m_queueStreams;
+  graph.syncPoints = m_syncPoints;
+  graph.signalValues = m_signalValues;
+}
+void FrameGraph::_restoreCompiled(const CompiledGraph &graph) {
+  // Counts are a part of the key.
+  const auto numPasses = static_cast<uint32_t>(m_passNodes.size());
+  assert(graph.refCounts.size() == numPasses + m_resourceNodes.size() &&
+         graph.entries.size() == m_resourceRegistry.size());
+  for (auto &pass : m_passNodes) {
+    const auto id = pass.getId();
+    pass.m_refCount = graph.refCounts[id];
+    const auto *offsets = graph.resourceListOffsets.data() + 2 * id;
+    const auto *lists = graph.resourceLists.data();
+    pass.m_acquires.assign(lists + offsets[0], lists + offsets[1]);
+    pass.m_releases.assign(lists + offsets[1], lists + offsets[2]);
+  }
+  for (auto &node : m_resourceNodes)
+    node.m_refCount = graph.refCounts[numPasses + node.getId()];
+  for (auto &entry : m_resourceRegistry) {
+    const auto &state = graph.entries[entry.getId()];
+    entry.m_heapOffset = state.heapOffset;
+    entry.m_producer = state.producer;
+    entry.m_last = state.last;
+  }
+
+  m_accesses = graph.accesses;
+  m_accessRanges = graph.accessRanges;
+  m_successorOffsets = graph.successorOffsets;
+  m_successors = graph.successors;
+  m_executionOrder = graph.executionOrder;
+  m_transientMemoryStats = graph.transientMemoryStats;
+
+  m_transitions = graph.transitions;
+  for (std::size_t i{0}; i < m_transitions.size(); ++i)
+    m_transitions[i].entry = &m_resourceRegistry[graph.transitionEntryIds[i]];
+  m_transitionRanges = graph.transitionRanges;
+  m_transitionStats = graph.transitionStats;
+  m_splitTransitions = graph.splitTransitions;
+  for (std::size_t i{0}; i < m_splitTransitions.size(); ++i)
+    m_splitTransitions[i].entry = &m_resourceRegistry[graph.splitEntryIds[i]];
+  m_splitRanges = graph.splitRanges;
+  m_splitBeginOffsets = graph.splitBeginOffsets;
+  m_splitBegins = graph.splitBegins;
+
+  m_mergeGroups = graph.mergeGroups;
+  m_subpasses = graph.subpasses;
+  m_queueStreams = graph.queueStreams;
+  m_syncPoints = graph.syncPoints;
+  m_signalValues = graph.signalValues;
+}
+
+FrameGraph::FrameGraph(const FrameGraph &parent, uint32_t slot)
+    : m_ownArena{std::in_place}, m_arena{&*m_ownArena}, m_parent{&parent},
+      m_slot{slot} {}
+
+void FrameGraph::_recycleNodes() {
+  // In reverse, so a node (at given index) gets the storage of its
+  // predecessor from the previous frame.
+  for (auto it = m_passNodes.rbegin(); it != m_passNodes.rend(); ++it) {
+    it->m_exec.reset();
+    m_passNodePool.emplace_back(std::move(*it));
+  }
+  m_passNodes.clear();
+  m_resourceNodes.clear();
+  m_resourceRegistry.clear();
+  m_compileKey.words.clear();
+  m_compileKey.hash = kHashSeed;
+}
+void FrameGraph::_merge(Recorder &recorder) {
+  auto &graph = recorder.m_graph;
+  const auto entryOffset = static_cast<uint32_t>(m_resourceRegistry.size());
+  recorder.m_nodeOffset = static_cast<uint32_t>(m_resourceNodes.size());
+
+  for (auto &entry : graph.m_resourceRegistry) {
+    entry.m_id += entryOffset;
+    _addToCompileKey(m_resourceRegistry.emplace_back(std::move(entry)));
+  }
+  for (const auto &node : graph.m_resourceNodes) {
+    _addToCompileKey(
+      _createResourceNode(m_names.intern(node.getName()),
+                          entryOffset + node.m_resourceId, node.m_version),
+      true);
+  }
+  // Declarations are replayed with handles resolved to nodes of this graph.
+  for (auto &pass : graph.m_passNodes) {
+    auto &node = _createPassNode(pass.getName(), std::move(pass.m_exec));
+    for (const auto id : pass.m_creates)
+      node._create(_resolve(id));
+    for (const auto [id, flags] : pass.m_reads)
+      node._read(_resolve(id), flags);
+    for (const auto [id, flags] : pass.m_writes) {
+      [[maybe_unused]] const auto written = node._write(_resolve(id), flags);
+    }
+    node.m_hasSideEffect = pass.m_hasSideEffect;
+    node.m_queue = pass.m_queue;
+    _addToCompileKey(node);
+  }
+  // The arena of the recorder is reset with this graph.
+  graph._recycleNodes();
+}
+
+FrameGraphResource FrameGraph::_toHandle(uint32_t nodeId) const {
+  assert(_getSlot(static_cast<FrameGraphResource>(nodeId)) == 0);
+  return static_cast<FrameGraphResource>(m_slot << kSlotShift | nodeId);
+}
+uint32_t FrameGraph::_resolve(FrameGraphResource id) const {
+  const auto slot = _getSlot(id);
+  const auto nodeId = static_cast<uint32_t>(id) & ((1u << kSlotShift) - 1);
+  if (slot == m_slot) return nodeId;
+  // Handles of other recorders are known to the main graph only.
+  assert(!m_parent && slot <= m_numRecorders);
+  const auto offset = m_recorders[slot - 1]->m_nodeOffset;
+  assert(offset != kInvalidId && "Recorder not merged");
+  return offset + nodeId;
+}
 
 PassNode &
 FrameGraph::_createPassNode(const std::string_view name,
-                            std::unique_ptr<FrameGraphPassConcept> &&base) {
+                            ArenaPtr<FrameGraphPassConcept> &&base) {
   const auto id = static_cast<uint32_t>(m_passNodes.size());
-  return m_passNodes.emplace_back(PassNode{name, id, std::move(base)});
+  const auto internedName = m_names.intern(name);
+  if (m_passNodePool.empty()) {
+    return m_passNodes.emplace_back(
+      PassNode{internedName, id, std::move(base)});
+  }
+
+  auto &node = m_passNodes.emplace_back(PassNode{
+    internedName, id, std::move(base), std::move(m_passNodePool.back())});
+  m_passNodePool.pop_back();
+  return node;
 }
 
-ResourceNode &FrameGraph::_createResourceNode(const std::string_view name,
+ResourceNode &FrameGraph::_createResourceNode(const NameTable::Name name,
                                               uint32_t resourceId,
                                               uint32_t version) {
   const auto id = static_cast<uint32_t>(m_resourceNodes.size());
@@ -111,17 +1345,21 @@ FrameGraphResource FrameGraph::_clone(FrameGraphResource id) {
   auto &entry = _getResourceEntry(node);
   entry.m_version++;
 
-  const auto &clone = _createResourceNode(node.getName(), node.getResourceId(),
-                                          entry.getVersion());
-  return clone.getId();
+  const auto &clone = _createResourceNode(
+    node.m_name, node.getResourceId(), entry.getVersion());
+  _addToCompileKey(clone, false);
+  return _toHandle(clone.getId());
 }
 
 const ResourceNode &FrameGraph::_getResourceNode(FrameGraphResource id) const {
-  assert(id < m_resourceNodes.size());
-  return m_resourceNodes[id];
+  if (_isForeign(id)) return m_parent->_getResourceNode(id);
+  const auto nodeId = _resolve(id);
+  assert(nodeId < m_resourceNodes.size());
+  return m_resourceNodes[nodeId];
 }
 const ResourceEntry &
 FrameGraph::_getResourceEntry(FrameGraphResource id) const {
+  if (_isForeign(id)) return m_parent->_getResourceEntry(id);
   return _getResourceEntry(_getResourceNode(id));
 }
 const ResourceEntry &
@@ -130,12 +1368,48 @@ FrameGraph::_getResourceEntry(const ResourceNode &node) const {
   return m_resourceRegistry[node.m_resourceId];
 }
 
+FrameGraph::Slice<FrameGraph::Access>
+FrameGraph::_getAccesses(uint32_t passId) const {
+  const auto &ranges = m_accessRanges[passId];
+  return {m_accesses.data() + ranges.creates, m_accesses.data() + ranges.end};
+}
+FrameGraph::Slice<FrameGraph::Access>
+FrameGraph::_getCreates(uint32_t passId) const {
+  const auto &ranges = m_accessRanges[passId];
+  return {m_accesses.data() + ranges.creates, m_accesses.data() + ranges.reads};
+}
+FrameGraph::Slice<FrameGraph::Access>
+FrameGraph::_getReads(uint32_t passId) const {
+  const auto &ranges = m_accessRanges[passId];
+  return {m_accesses.data() + ranges.reads, m_accesses.data() + ranges.writes};
+}
+FrameGraph::Slice<FrameGraph::Access>
+FrameGraph::_getWrites(uint32_t passId) const {
+  const auto &ranges = m_accessRanges[passId];
+  return {m_accesses.data() + ranges.writes, m_accesses.data() + ranges.end};
+}
+FrameGraph::Slice<uint32_t> FrameGraph::_getReaders(uint32_t nodeId) const {
+  return {m_readers.data() + m_readerOffsets[nodeId],
+          m_readers.data() + m_readerOffsets[nodeId + 1]};
+}
+FrameGraph::Slice<uint32_t> FrameGraph::_getSuccessors(uint32_t passId) const {
+  return {m_successors.data() + m_successorOffsets[passId],
+          m_successors.data() + m_successorOffsets[passId + 1]};
+}
+
 // ---
 
 std::ostream &operator<<(std::ostream &os, const FrameGraph &fg) {
   return fg.debugOutput(os, graphviz::Writer{});
 }
 
+//
+// FrameGraph::Recorder class:
+//
+
+FrameGraph::Recorder::Recorder(const FrameGraph &parent, uint32_t slot)
+    : m_graph{parent, slot}, m_nodeOffset{kInvalidId} {}
+
 //
 // FrameGraph::Builder class:
 //
@@ -143,11 +1417,14 @@ std::ostream &operator<<(std::ostream &os, const FrameGraph &fg) {
 FrameGraphResource FrameGraph::Builder::read(FrameGraphResource id,
                                              uint32_t flags) {
   assert(m_frameGraph.isValid(id));
-  return m_passNode._read(id, flags);
+  return m_passNode._read(m_frameGraph._canonicalize(id), flags);
 }
 FrameGraphResource FrameGraph::Builder::write(FrameGraphResource id,
                                               uint32_t flags) {
   assert(m_frameGraph.isValid(id));
+  // A recorder can't rename resources of the main graph.
+  assert(!m_frameGraph._isForeign(id));
+  id = m_frameGraph._canonicalize(id);
   if (m_frameGraph._getResourceEntry(id).isImported()) setSideEffect();
 
   if (m_passNode.creates(id)) {
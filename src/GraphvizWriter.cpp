@@ -1,6 +1,6 @@
 #include "fg/GraphvizWriter.hpp"
 #include <sstream>
-#if __cplusplus >= 202002L
+#if __cplusplus >= 202002L && __has_include(<format>)
 #  include <format>
 #endif
 #include <cassert>
@@ -245,14 +245,14 @@ std::ostream &operator<<(std::ostream &os, const Graph &graph) {
 }
 
 [[nodiscard]] auto makeKey(const PassNode &node) {
-#if __cplusplus >= 202002L
+#ifdef __cpp_lib_format
   return std::format("P{}", node.getId());
 #else
   return "P" + std::to_string(node.getId());
 #endif
 }
 [[nodiscard]] auto makeKey(const ResourceNode &node) {
-#if __cplusplus >= 202002L
+#ifdef __cpp_lib_format
   return std::format("R{}_{}", node.getResourceId(), node.getVersion());
 #else
   return "R" + std::to_string(node.getResourceId()) + "_" +
@@ -305,34 +305,41 @@ void Writer::operator()(const PassNode &node,
     key,
     stringify(node),
     node.canExecute() ? colors.pass.executed : colors.pass.culled,
+    {},
   });
   for (const auto id : node.each(PassNode::Create{})) {
     vertex.cluster.emplace_back(makeKey(resourceNodes[id]));
   }
 
-  auto &edge =
-    graph.edges.emplace_back(Graph::Edge{std::move(key), colors.edge.write});
+  // Gathered here, so a resource doesn't have to look for its readers.
+  for (const auto [id, _] : node.each(PassNode::Read{})) {
+    if (std::size_t(id) >= readers.size()) readers.resize(id + 1);
+    // The same resource might be read with different flags.
+    if (readers[id].empty() || readers[id].back() != key)
+      readers[id].emplace_back(key);
+  }
+
+  auto &edge = graph.edges.emplace_back(
+    Graph::Edge{std::move(key), colors.edge.write, {}});
   for (const auto [id, _] : node.each(PassNode::Write{})) {
     edge.vertices.emplace_back(makeKey(resourceNodes[id]));
   }
 }
 
 void Writer::operator()(const ResourceNode &node, const ResourceEntry &entry,
-                        const std::vector<PassNode> &passNodes) {
+                        const std::vector<PassNode> &) {
   auto key = makeKey(node);
   graph.vertices.emplace_back(Graph::Vertex{
     key,
     stringify(node, entry),
     entry.isImported() ? colors.resource.imported : colors.resource.transient,
+    {},
   });
 
-  auto &edge =
-    graph.edges.emplace_back(Graph::Edge{std::move(key), colors.edge.read});
-  for (const auto &pass : passNodes) {
-    if (pass.reads(node.getId())) {
-      edge.vertices.emplace_back(makeKey(pass));
-    }
-  }
+  auto &edge = graph.edges.emplace_back(
+    Graph::Edge{std::move(key), colors.edge.read, {}});
+  if (node.getId() < readers.size())
+    edge.vertices = std::move(readers[node.getId()]);
   if (entry.isImported()) graph.imported.emplace_back(entry.getId());
 }
 
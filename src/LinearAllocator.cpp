@@ -0,0 +1,77 @@
+#include "fg/LinearAllocator.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cassert>
+
+namespace {
+
+[[nodiscard]] std::size_t alignUp(std::size_t offset, std::size_t alignment) {
+  assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+LinearAllocator::LinearAllocator(std::size_t blockSize)
+    : m_blockSize{blockSize} {
+  assert(blockSize > 0);
+}
+LinearAllocator::LinearAllocator(LinearAllocator &&other) noexcept
+    : m_blockSize{other.m_blockSize}, m_blocks{std::move(other.m_blocks)},
+      m_currentBlock{std::exchange(other.m_currentBlock, 0)},
+      m_offset{std::exchange(other.m_offset, 0)},
+      m_size{std::exchange(other.m_size, 0)} {
+  other.m_blocks.clear();
+}
+
+LinearAllocator &LinearAllocator::operator=(LinearAllocator &&rhs) noexcept {
+  if (this != &rhs) {
+    m_blockSize = rhs.m_blockSize;
+    m_blocks = std::move(rhs.m_blocks);
+    rhs.m_blocks.clear();
+    m_currentBlock = std::exchange(rhs.m_currentBlock, 0);
+    m_offset = std::exchange(rhs.m_offset, 0);
+    m_size = std::exchange(rhs.m_size, 0);
+  }
+  return *this;
+}
+
+void *LinearAllocator::allocate(std::size_t size, std::size_t alignment) {
+  // Blocks are allocated with operator new[], so the base address meets the
+  // fundamental alignment, larger ones are handled by the padding.
+  const auto fits = [size, alignment](const Block &block, std::size_t offset) {
+    const auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+    return alignUp(base + offset, alignment) - base + size <= block.size;
+  };
+  while (m_currentBlock < m_blocks.size() &&
+         !fits(m_blocks[m_currentBlock], m_offset)) {
+    ++m_currentBlock;
+    m_offset = 0;
+  }
+  if (m_currentBlock == m_blocks.size()) {
+    const auto blockSize = std::max(m_blockSize, size + alignment);
+    m_blocks.push_back(
+      {std::make_unique<std::byte[]>(blockSize), blockSize});
+    m_offset = 0;
+  }
+
+  auto &block = m_blocks[m_currentBlock];
+  const auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+  const auto begin = alignUp(base + m_offset, alignment) - base;
+  m_offset = begin + size;
+  m_size += size;
+  return block.memory.get() + begin;
+}
+
+void LinearAllocator::reset() {
+  m_currentBlock = 0;
+  m_offset = 0;
+  m_size = 0;
+}
+
+std::size_t LinearAllocator::getCapacity() const {
+  return std::accumulate(
+    m_blocks.cbegin(), m_blocks.cend(), std::size_t{0},
+    [](std::size_t sum, const Block &block) { return sum + block.size; });
+}
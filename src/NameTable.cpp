@@ -0,0 +1,23 @@
+#include "fg/NameTable.hpp"
+#include <cstring>
+
+NameTable::NameTable() : m_storage{4 * 1024} {}
+
+NameTable::Name NameTable::intern(const std::string_view name) {
+  if (const auto it = m_ids.find(name); it != m_ids.cend())
+    return {it->first, it->second};
+
+  auto *storage = static_cast<char *>(m_storage.allocate(name.size() + 1, 1));
+  std::memcpy(storage, name.data(), name.size());
+  storage[name.size()] = '\0';
+  const std::string_view string{storage, name.size()};
+
+  const auto id = static_cast<uint32_t>(m_ids.size());
+  m_ids.emplace(string, id);
+  return {string, id};
+}
+
+void NameTable::clear() {
+  m_ids.clear();
+  m_storage.reset();
+}
@@ -4,7 +4,8 @@
 
 namespace {
 
-[[nodiscard]] bool hasId(const std::vector<FrameGraphResource> &v,
+template <uint32_t N>
+[[nodiscard]] bool hasId(const SmallVector<FrameGraphResource, N> &v,
                          FrameGraphResource id) {
 #if __cplusplus >= 202002L
   return std::ranges::find(v, id) != v.cend();
@@ -12,7 +13,8 @@ namespace {
   return std::find(v.cbegin(), v.cend(), id) != v.cend();
 #endif
 }
-[[nodiscard]] bool hasId(const std::vector<PassNode::AccessDeclaration> &v,
+template <uint32_t N>
+[[nodiscard]] bool hasId(const SmallVector<PassNode::AccessDeclaration, N> &v,
                          FrameGraphResource id) {
   const auto match = [id](const auto &e) { return e.id == id; };
 #if __cplusplus >= 202002L
@@ -22,8 +24,10 @@ namespace {
 #endif
 }
 
-[[nodiscard]] bool contains(const std::vector<PassNode::AccessDeclaration> &v,
-                            PassNode::AccessDeclaration n) {
+template <uint32_t N>
+[[nodiscard]] bool
+contains(const SmallVector<PassNode::AccessDeclaration, N> &v,
+         PassNode::AccessDeclaration n) {
 #if __cplusplus >= 202002L
   return std::ranges::find(v, n) != v.cend();
 #else
@@ -34,33 +38,100 @@ namespace {
 } // namespace
 
 bool PassNode::creates(FrameGraphResource id) const {
-  return hasId(m_creates, id);
+  return m_index.empty() ? hasId(m_creates, id) : _hasAccess(id, kCreate);
+}
+bool PassNode::reads(FrameGraphResource id) const {
+  return m_index.empty() ? hasId(m_reads, id) : _hasAccess(id, kRead);
 }
-bool PassNode::reads(FrameGraphResource id) const { return hasId(m_reads, id); }
 bool PassNode::writes(FrameGraphResource id) const {
-  return hasId(m_writes, id);
+  return m_index.empty() ? hasId(m_writes, id) : _hasAccess(id, kWrite);
 }
 
 //
 // (private):
 //
 
-PassNode::PassNode(const std::string_view name, uint32_t nodeId,
-                   std::unique_ptr<FrameGraphPassConcept> &&exec)
-    : GraphNode{name, nodeId}, m_exec{std::move(exec)} {
-  m_creates.reserve(10);
-  m_reads.reserve(10);
-  m_writes.reserve(10);
+PassNode::PassNode(const NameTable::Name name, uint32_t nodeId,
+                   ArenaPtr<FrameGraphPassConcept> &&exec)
+    : GraphNode{name, nodeId}, m_exec{std::move(exec)} {}
+PassNode::PassNode(const NameTable::Name name, uint32_t nodeId,
+                   ArenaPtr<FrameGraphPassConcept> &&exec,
+                   PassNode &&recycled)
+    : GraphNode{name, nodeId}, m_exec{std::move(exec)},
+      m_creates{std::move(recycled.m_creates)},
+      m_reads{std::move(recycled.m_reads)},
+      m_writes{std::move(recycled.m_writes)},
+      m_index{std::move(recycled.m_index)},
+      m_acquires{std::move(recycled.m_acquires)},
+      m_releases{std::move(recycled.m_releases)} {
+  m_creates.clear();
+  m_reads.clear();
+  m_writes.clear();
+  m_index.clear();
+  m_acquires.clear();
+  m_releases.clear();
 }
 
+FrameGraphResource PassNode::_create(FrameGraphResource id) {
+  m_creates.emplace_back(id);
+  _addAccess(id, kCreate);
+  return id;
+}
 FrameGraphResource PassNode::_read(FrameGraphResource id, uint32_t flags) {
   assert(!creates(id) && !writes(id));
-  return contains(m_reads, {id, flags})
-           ? id
-           : m_reads.emplace_back(AccessDeclaration{id, flags}).id;
+  // The declaration list is scanned only if the pass reads the resource
+  // already (possibly with different flags).
+  if (reads(id) && contains(m_reads, {id, flags})) return id;
+  m_reads.emplace_back(AccessDeclaration{id, flags});
+  _addAccess(id, kRead);
+  return id;
 }
 FrameGraphResource PassNode::_write(FrameGraphResource id, uint32_t flags) {
-  return contains(m_writes, {id, flags})
-           ? id
-           : m_writes.emplace_back(AccessDeclaration{id, flags}).id;
+  if (writes(id) && contains(m_writes, {id, flags})) return id;
+  m_writes.emplace_back(AccessDeclaration{id, flags});
+  _addAccess(id, kWrite);
+  return id;
+}
+
+uint32_t PassNode::_findSlot(FrameGraphResource id) const {
+  assert(id != kEmptySlot);
+  // Fibonacci hashing, capacity is a power of two.
+  const auto mask = static_cast<uint32_t>(m_index.size()) - 1;
+  auto i = (static_cast<uint32_t>(id) * 2654435769u) & mask;
+  while (m_index[i].id != kEmptySlot && m_index[i].id != id)
+    i = (i + 1) & mask;
+  return i;
+}
+bool PassNode::_hasAccess(FrameGraphResource id, uint8_t access) const {
+  return (m_index[_findSlot(id)].access & access) != 0;
+}
+void PassNode::_addAccess(FrameGraphResource id, uint8_t access) {
+  if (m_index.empty()) {
+    const auto numAccesses =
+      m_creates.size() + m_reads.size() + m_writes.size();
+    if (numAccesses > kIndexThreshold) _rebuildIndex(4 * kIndexThreshold);
+  } else if (2 * (m_numIndexed + 1) > m_index.size()) {
+    // Load factor <= 0.5, the new access is indexed from declarations.
+    _rebuildIndex(2 * static_cast<uint32_t>(m_index.size()));
+  } else {
+    _insertIndex(id, access);
+  }
+}
+void PassNode::_insertIndex(FrameGraphResource id, uint8_t access) {
+  auto &slot = m_index[_findSlot(id)];
+  if (slot.id == kEmptySlot) {
+    slot.id = id;
+    ++m_numIndexed;
+  }
+  slot.access |= access;
+}
+void PassNode::_rebuildIndex(uint32_t capacity) {
+  m_index.assign(capacity, IndexSlot{});
+  m_numIndexed = 0;
+  for (const auto id : m_creates)
+    _insertIndex(id, kCreate);
+  for (const auto [id, _] : m_reads)
+    _insertIndex(id, kRead);
+  for (const auto [id, _] : m_writes)
+    _insertIndex(id, kWrite);
 }
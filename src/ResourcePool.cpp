@@ -0,0 +1,33 @@
+#include "fg/ResourcePool.hpp"
+
+FrameGraphResourcePool::FrameGraphResourcePool(uint32_t maxUnusedFrames)
+    : m_maxUnusedFrames{maxUnusedFrames} {}
+
+void FrameGraphResourcePool::update(void *allocator) {
+  ++m_frame;
+  for (auto it = m_buckets.begin(); it != m_buckets.end();) {
+    auto &slots = it->second;
+    for (auto slot = slots.begin(); slot != slots.end();) {
+      if (m_frame - (*slot)->lastUsed <= m_maxUnusedFrames) {
+        ++slot;
+        continue;
+      }
+      if ((*slot)->occupied) {
+        (*slot)->destroy(allocator);
+        ++m_stats.numEvictions;
+        --m_stats.numPooled;
+      }
+      slot = slots.erase(slot);
+    }
+    it = slots.empty() ? m_buckets.erase(it) : std::next(it);
+  }
+}
+void FrameGraphResourcePool::clear(void *allocator) {
+  for (auto &[_, slots] : m_buckets) {
+    for (auto &slot : slots) {
+      if (slot->occupied) slot->destroy(allocator);
+    }
+  }
+  m_buckets.clear();
+  m_stats.numPooled = 0;
+}
@@ -0,0 +1,94 @@
+#include "fg/ThreadPool.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// Worker of a pool that runs on the current thread (if any).
+thread_local const FrameGraphThreadPool *t_pool{nullptr};
+thread_local uint32_t t_workerIndex{0};
+
+} // namespace
+
+FrameGraphThreadPool::FrameGraphThreadPool(uint32_t numWorkers)
+    : m_numWorkers{std::max(numWorkers, 1u)},
+      m_queues{std::make_unique<Queue[]>(m_numWorkers)} {
+  m_threads.reserve(m_numWorkers);
+  for (auto i = 0u; i < m_numWorkers; ++i) {
+    m_threads.emplace_back(&FrameGraphThreadPool::_run, this, i);
+  }
+}
+FrameGraphThreadPool::~FrameGraphThreadPool() {
+  {
+    std::lock_guard lock{m_mutex};
+    m_stop = true;
+  }
+  m_wakeUp.notify_all();
+  for (auto &thread : m_threads)
+    thread.join();
+}
+
+uint32_t FrameGraphThreadPool::getNumWorkers() const { return m_numWorkers; }
+
+void FrameGraphThreadPool::submit(const Job &job) {
+  assert(job.function);
+  // Counted before the push, so a worker never sees a job that is not pending.
+  {
+    std::lock_guard lock{m_mutex};
+    ++m_numPendingJobs;
+  }
+  const auto queueIndex =
+    t_pool == this ? t_workerIndex : m_nextQueue++ % m_numWorkers;
+  {
+    auto &queue = m_queues[queueIndex];
+    std::lock_guard lock{queue.mutex};
+    queue.jobs.push_back(job);
+  }
+  m_wakeUp.notify_one();
+}
+
+//
+// (private):
+//
+
+void FrameGraphThreadPool::_run(uint32_t workerIndex) {
+  t_pool = this;
+  t_workerIndex = workerIndex;
+
+  while (true) {
+    if (Job job{}; _tryPop(workerIndex, job)) {
+      {
+        std::lock_guard lock{m_mutex};
+        --m_numPendingJobs;
+      }
+      job.function(job.data, workerIndex);
+      continue;
+    }
+    std::unique_lock lock{m_mutex};
+    m_wakeUp.wait(lock, [this] { return m_stop || m_numPendingJobs > 0; });
+    if (m_stop) break;
+  }
+}
+bool FrameGraphThreadPool::_tryPop(uint32_t workerIndex, Job &job) {
+  // Own queue first (LIFO, recently submitted jobs are likely to be hot in
+  // cache), then steal from the others (FIFO).
+  {
+    auto &queue = m_queues[workerIndex];
+    std::lock_guard lock{queue.mutex};
+    if (!queue.jobs.empty()) {
+      job = queue.jobs.back();
+      queue.jobs.pop_back();
+      return true;
+    }
+  }
+  for (auto i = 1u; i < m_numWorkers; ++i) {
+    auto &queue = m_queues[(workerIndex + i) % m_numWorkers];
+    std::lock_guard lock{queue.mutex};
+    if (!queue.jobs.empty()) {
+      job = queue.jobs.front();
+      queue.jobs.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
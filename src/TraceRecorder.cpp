@@ -0,0 +1,124 @@
+#include "fg/TraceRecorder.hpp"
+#include "fg/PassNode.hpp"
+#include <cassert>
+#include <cstdio>
+
+namespace {
+
+void writeEscaped(std::ostream &os, const std::string_view str) {
+  constexpr char kHexDigits[] = "0123456789abcdef";
+  for (const auto c : str) {
+    switch (c) {
+    case '"':
+      os << "\\\"";
+      break;
+    case '\\':
+      os << "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        os << "\\u00" << kHexDigits[c >> 4] << kHexDigits[c & 0xF];
+      } else {
+        os << c;
+      }
+    }
+  }
+}
+
+} // namespace
+
+//
+// FrameGraphInstrumentation class:
+//
+
+const char *FrameGraphInstrumentation::toString(Phase phase) {
+  switch (phase) {
+  case Phase::Create:
+    return "Create";
+  case Phase::Barriers:
+    return "Barriers";
+  case Phase::Execute:
+    return "Execute";
+  case Phase::Destroy:
+    return "Destroy";
+  }
+  assert(false);
+  return "";
+}
+
+//
+// FrameGraphTraceRecorder class:
+//
+
+FrameGraphTraceRecorder::FrameGraphTraceRecorder(uint32_t numWorkers)
+    : m_start{Clock::now()}, m_workers(numWorkers) {}
+
+void FrameGraphTraceRecorder::beginPass(const PassNode &pass,
+                                        uint32_t workerIndex) {
+  _record(&pass, {}, 'B', workerIndex);
+}
+void FrameGraphTraceRecorder::endPass(const PassNode &pass,
+                                      uint32_t workerIndex) {
+  _record(&pass, {}, 'E', workerIndex);
+}
+
+void FrameGraphTraceRecorder::beginPhase(Phase phase, const PassNode &,
+                                         uint32_t workerIndex) {
+  _record(nullptr, phase, 'B', workerIndex);
+}
+void FrameGraphTraceRecorder::endPhase(Phase phase, const PassNode &,
+                                       uint32_t workerIndex) {
+  _record(nullptr, phase, 'E', workerIndex);
+}
+
+std::size_t FrameGraphTraceRecorder::getNumEvents() const {
+  std::size_t numEvents{0};
+  for (const auto &worker : m_workers)
+    numEvents += worker.events.size();
+  return numEvents;
+}
+void FrameGraphTraceRecorder::write(std::ostream &os) const {
+  os << "{\"traceEvents\":[";
+  auto separator = "";
+  for (std::size_t workerIndex{0}; workerIndex < m_workers.size();
+       ++workerIndex) {
+    for (const auto &[name, phase, isPass, type, timestamp] :
+         m_workers[workerIndex].events) {
+      char ts[32];
+      std::snprintf(
+        ts, sizeof(ts), "%.3f",
+        std::chrono::duration<double, std::micro>{timestamp - m_start}.count());
+      os << separator << "\n{\"name\":\"";
+      separator = ",";
+      if (isPass) {
+        writeEscaped(os, name);
+        os << "\",\"cat\":\"Pass";
+      } else {
+        os << toString(phase) << "\",\"cat\":\"Phase";
+      }
+      os << "\",\"ph\":\"" << type << "\",\"ts\":" << ts
+         << ",\"pid\":0,\"tid\":" << workerIndex << "}";
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+void FrameGraphTraceRecorder::clear() {
+  for (auto &worker : m_workers) {
+    worker.events.clear();
+    worker.names.clear();
+  }
+}
+
+//
+// (private):
+//
+
+void FrameGraphTraceRecorder::_record(const PassNode *pass, Phase phase,
+                                      char type, uint32_t workerIndex) {
+  const auto timestamp = Clock::now();
+  assert(workerIndex < m_workers.size());
+  auto &[names, events] = m_workers[workerIndex];
+  const auto name =
+    pass ? names.intern(pass->getName()).string : std::string_view{};
+  events.push_back({name, phase, pass != nullptr, type, timestamp});
+}
@@ -1,7 +1,36 @@
 #include <catch.hpp>
 #include "fg/FrameGraph.hpp"
 #include "fg/Blackboard.hpp"
+#include "fg/CompileCache.hpp"
+#include "fg/ThreadPool.hpp"
+#include "fg/CpuQueues.hpp"
+#include "fg/ResourcePool.hpp"
+#include "fg/StaticPipeline.hpp"
+#include "fg/TraceRecorder.hpp"
+#include "fg/SmallVector.hpp"
+#include "fg/NameTable.hpp"
 #include <fstream>
+#include <sstream>
+#include <array>
+#include <tuple>
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <thread>
+#include <chrono>
+
+// Allocation counting (per thread), see "Reset" test.
+static thread_local std::size_t g_numAllocations{0};
+
+void *operator new(std::size_t size) {
+  ++g_numAllocations;
+  if (auto *ptr = std::malloc(size); ptr) return ptr;
+  throw std::bad_alloc{};
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
 
 struct BadResource {
   struct Desc {};
@@ -51,12 +80,97 @@ public:
   ~Fixture() { FrameGraphTexture::m_lastId = 0; }
 };
 
+struct FrameGraphBuffer {
+  struct Desc {
+    uint32_t size;
+  };
+
+  void create(const Desc &, void *) {
+    alive = true;
+    ++numAlive;
+  }
+  void destroy(const Desc &, void *) {
+    alive = false;
+    --numAlive;
+  }
+
+  bool alive{false};
+
+  inline static std::atomic<int32_t> numAlive{0};
+};
+
+struct FrameGraphHeapBuffer {
+  struct Desc {
+    uint64_t size;
+  };
+
+  struct MemoryRequirements {
+    uint64_t size;
+    uint64_t alignment;
+  };
+  static MemoryRequirements memoryRequirements(const Desc &desc) {
+    return {desc.size, 256};
+  }
+
+  void create(const Desc &, void *, uint64_t heapOffset) {
+    offset = heapOffset;
+  }
+  void create(const Desc &, void *) {}
+  void destroy(const Desc &, void *) {}
+
+  uint64_t offset{~0ull};
+};
+
+struct FrameGraphPooledTexture {
+  struct Desc {
+    uint32_t width;
+    uint32_t height;
+
+    bool operator==(const Desc &other) const {
+      return width == other.width && height == other.height;
+    }
+  };
+
+  void create(const Desc &, void *) { id = ++numCreated; }
+  void destroy(const Desc &, void *) { ++numDestroyed; }
+
+  int32_t id{-1};
+
+  inline static int32_t numCreated{0};
+  inline static int32_t numDestroyed{0};
+};
+template <> struct std::hash<FrameGraphPooledTexture::Desc> {
+  std::size_t operator()(const FrameGraphPooledTexture::Desc &desc) const {
+    return (std::size_t{desc.width} << 32) | desc.height;
+  }
+};
+
+// Hashable descriptor, but not move assignable.
+struct FrameGraphUnpooledTexture {
+  using Desc = FrameGraphPooledTexture::Desc;
+
+  FrameGraphUnpooledTexture() = default;
+  FrameGraphUnpooledTexture(FrameGraphUnpooledTexture &&) noexcept = default;
+
+  void create(const Desc &, void *) {}
+  void destroy(const Desc &, void *) {}
+};
+
+static_assert(FrameGraphResourcePool::isPoolable<FrameGraphPooledTexture>());
+static_assert(!FrameGraphResourcePool::isPoolable<FrameGraphUnpooledTexture>());
+static_assert(!FrameGraphResourcePool::isPoolable<FrameGraphTexture>());
+static_assert(!FrameGraphResourcePool::isPoolable<FrameGraphHeapBuffer>());
+
 #if __cplusplus >= 202002L
 static_assert(Virtualizable<FrameGraphTexture>);
+static_assert(has_memoryRequirements<FrameGraphHeapBuffer>);
+static_assert(!has_memoryRequirements<FrameGraphTexture>);
 static_assert(has_preRead<FrameGraphTexture>);
 static_assert(!has_preWrite<FrameGraphTexture>);
 #else
 static_assert(is_resource<FrameGraphTexture>);
+static_assert(has_memoryRequirements<FrameGraphHeapBuffer>::value);
+static_assert(!has_memoryRequirements<FrameGraphTexture>::value);
 static_assert(has_preRead<FrameGraphTexture>::value);
 static_assert(!has_preWrite<FrameGraphTexture>::value);
 #endif
@@ -193,6 +307,48 @@ TEST_CASE_METHOD(Fixture, "Culled pass", "[FrameGraph]") {
   fg.execute();
   REQUIRE_FALSE(testPass.executed);
 }
+TEST_CASE_METHOD(Fixture, "Pass with many resources", "[FrameGraph]") {
+  FrameGraph fg;
+
+  constexpr auto kNumResources = 100;
+  std::vector<FrameGraphResource> textures;
+  for (auto i = 0; i < kNumResources; ++i) {
+    textures.emplace_back(fg.import("Texture", {1, 1}, FrameGraphTexture{i}));
+  }
+
+  struct PassData {
+    std::vector<FrameGraphResource> written;
+    mutable bool executed{false};
+  };
+  const auto &pass = fg.addCallbackPass<PassData>(
+    "Bindless",
+    [&textures](FrameGraph::Builder &builder, PassData &data) {
+      for (auto i = 0; i < kNumResources; ++i) {
+        if (i % 2 == 0) {
+          builder.read(textures[i]);
+          builder.read(textures[i]); // Deduplicated.
+        } else {
+          data.written.emplace_back(builder.write(textures[i]));
+        }
+      }
+    },
+    [&textures](const PassData &data, FrameGraphPassResources &resources,
+                void *) {
+      for (auto i = 0; i < kNumResources; i += 2) {
+        CHECK(resources.get<FrameGraphTexture>(textures[i]).id == i);
+      }
+      for (const auto id : data.written) {
+        CHECK(resources.get<FrameGraphTexture>(id).id % 2 == 1);
+      }
+      data.executed = true;
+    });
+
+  REQUIRE(pass.written.size() == kNumResources / 2);
+
+  fg.compile();
+  fg.execute();
+  REQUIRE(pass.executed);
+}
 TEST_CASE_METHOD(Fixture, "Deferred pipeline", "[FrameGraph]") {
   FrameGraph fg;
   auto backbufferId =
@@ -268,6 +424,1207 @@ TEST_CASE_METHOD(Fixture, "Deferred pipeline", "[FrameGraph]") {
   REQUIRE_FALSE(dummyPass.executed);
 }
 
+TEST_CASE_METHOD(Fixture, "Compile cache", "[FrameGraph]") {
+  FrameGraphCompileCache cache;
+
+  struct PassData {
+    FrameGraphResource foo;
+    mutable bool executed{false};
+  };
+  const auto frame = [&cache](bool withConsumer) {
+    FrameGraph fg;
+    fg.setCompileCache(&cache);
+    const auto backbuffer =
+      fg.import("Backbuffer", {1280, 720}, FrameGraphTexture{1});
+    auto &producer = fg.addCallbackPass<PassData>(
+      "Producer",
+      [](FrameGraph::Builder &builder, PassData &data) {
+        data.foo = builder.create<FrameGraphTexture>("foo", {128, 128});
+        data.foo = builder.write(data.foo);
+      },
+      markAsExecuted);
+    if (withConsumer) {
+      fg.addCallbackPass<PassData>(
+        "Consumer",
+        [&producer, backbuffer](FrameGraph::Builder &builder, PassData &data) {
+          builder.read(producer.foo);
+          data.foo = builder.write(backbuffer);
+        },
+        markAsExecuted);
+    }
+    fg.compile();
+    fg.execute();
+    return producer.executed;
+  };
+
+  REQUIRE(frame(true));
+  CHECK(cache.getNumMisses() == 1);
+  REQUIRE(frame(true));
+  CHECK(cache.getNumHits() == 1);
+
+  REQUIRE_FALSE(frame(false));
+  CHECK(cache.getNumMisses() == 2);
+  REQUIRE(frame(true));
+  CHECK(cache.getNumHits() == 2);
+
+  // Descriptors matter only through memory requirements (of aliased
+  // transients), which heap offsets depend on. The texture differs each time.
+  uint32_t width{0};
+  const auto resized = [&cache, &width](FrameGraph::Schedule schedule,
+                                        uint64_t size) {
+    FrameGraph fg;
+    fg.setCompileCache(&cache);
+    fg.setSchedule(schedule);
+    fg.addCallbackPass(
+      "Pass",
+      [size, &width](FrameGraph::Builder &builder, auto &) {
+        std::ignore = builder.write(
+          builder.create<FrameGraphHeapBuffer>("Buffer", {size}));
+        std::ignore = builder.write(
+          builder.create<FrameGraphTexture>("Texture", {++width, 1}));
+        builder.setSideEffect();
+      },
+      [](const auto &, FrameGraphPassResources &, void *) {});
+    fg.compile();
+    return fg.getTransientMemoryStats().heapSize;
+  };
+  using Schedule = FrameGraph::Schedule;
+  CHECK(resized(Schedule::DeclarationOrder, 256) == 256);
+  CHECK(resized(Schedule::DeclarationOrder, 512) == 512);
+  CHECK(cache.getNumMisses() == 4);
+  CHECK(resized(Schedule::DeclarationOrder, 256) == 256);
+  CHECK(cache.getNumHits() == 3);
+  // So do settings of compile().
+  CHECK(resized(Schedule::MinimizeMemory, 256) == 256);
+  CHECK(cache.getNumMisses() == 5);
+}
+
+TEST_CASE_METHOD(Fixture, "Reset", "[FrameGraph]") {
+  FrameGraph fg;
+
+  struct PassData {
+    FrameGraphResource foo;
+  };
+  const auto frame = [&fg] {
+    const auto backbuffer =
+      fg.import("Backbuffer", {1280, 720}, FrameGraphTexture{1});
+    auto &pass1 = fg.addCallbackPass<PassData>(
+      "Pass1",
+      [](FrameGraph::Builder &builder, PassData &data) {
+        // Longer than any small string buffer.
+        data.foo = builder.create<FrameGraphTexture>(
+          "Screen space ambient occlusion", {128, 128});
+        data.foo = builder.write(data.foo);
+      },
+      [](const PassData &, FrameGraphPassResources &, void *) {});
+    fg.addCallbackPass<PassData>(
+      "Pass2",
+      [&pass1, backbuffer](FrameGraph::Builder &builder, PassData &data) {
+        builder.read(pass1.foo);
+        data.foo = builder.write(backbuffer);
+      },
+      [](const PassData &, FrameGraphPassResources &, void *) {});
+    fg.compile();
+    fg.execute();
+    fg.reset();
+  };
+
+  frame();
+  const auto numAllocations = g_numAllocations;
+  frame();
+  // Graph topology reuses memory of the previous frame, passes and resources
+  // live in the frame arena.
+  CHECK(g_numAllocations == numAllocations);
+
+  // Names generated per frame don't accumulate.
+  for (auto i = 0; i < 100; ++i) {
+    fg.addCallbackPass(
+      "Pass" + std::to_string(i),
+      [](FrameGraph::Builder &builder, auto &) { builder.setSideEffect(); },
+      [](const auto &, FrameGraphPassResources &, void *) {});
+    fg.reset();
+  }
+  CHECK(fg.getNumNames() <= 2);
+}
+
+TEST_CASE_METHOD(Fixture, "Large capture", "[FrameGraph]") {
+  LinearAllocator arena{1024};
+  FrameGraph fg{arena};
+
+  struct TestPass {
+    mutable bool executed{false};
+  };
+  std::array<uint8_t, 4096> payload{};
+  payload.back() = 42;
+  auto &testPass = fg.addCallbackPass<TestPass>(
+    "Test pass",
+    [](FrameGraph::Builder &builder, TestPass &) { builder.setSideEffect(); },
+    [payload](const TestPass &data, FrameGraphPassResources &, void *) {
+      CHECK(payload.back() == 42);
+      data.executed = true;
+    });
+  CHECK(arena.getSize() >= sizeof(payload));
+
+  fg.compile();
+  fg.execute();
+  REQUIRE(testPass.executed);
+}
+
+TEST_CASE("Linear allocator", "[LinearAllocator]") {
+  LinearAllocator arena{256};
+
+  auto *a = arena.allocate(100, 4);
+  auto *b = arena.allocate(100, 64);
+  CHECK(reinterpret_cast<std::uintptr_t>(b) % 64 == 0);
+  auto *c = arena.allocate(1000, 16); // Larger than a block.
+  CHECK(reinterpret_cast<std::uintptr_t>(c) % 16 == 0);
+  const auto capacity = arena.getCapacity();
+
+  arena.reset();
+  CHECK(arena.getSize() == 0);
+  CHECK(arena.allocate(100, 4) == a);
+  CHECK(arena.allocate(100, 64) == b);
+  CHECK(arena.allocate(1000, 16) == c);
+  CHECK(arena.getCapacity() == capacity);
+
+  // Blocks are taken over, the moved-from arena starts anew.
+  LinearAllocator moved{std::move(arena)};
+  CHECK(moved.getCapacity() == capacity);
+  CHECK(arena.getSize() == 0);
+  CHECK(arena.getCapacity() == 0);
+  CHECK(arena.allocate(100, 4) != nullptr);
+  arena = std::move(moved);
+  CHECK(arena.getCapacity() == capacity);
+  CHECK(moved.getCapacity() == 0);
+}
+
+TEST_CASE("Name table", "[NameTable]") {
+  NameTable names;
+
+  const auto ssao = names.intern(std::string{"Screen space ambient occlusion"});
+  CHECK(ssao.string == "Screen space ambient occlusion");
+
+  const auto numAllocations = g_numAllocations;
+  const auto same = names.intern("Screen space ambient occlusion");
+  CHECK(g_numAllocations == numAllocations);
+  CHECK(same.id == ssao.id);
+  CHECK(same.string.data() == ssao.string.data());
+
+  CHECK(names.intern("Bloom").id != ssao.id);
+  CHECK(names.size() == 2);
+}
+
+TEST_CASE("Small vector", "[SmallVector]") {
+  SmallVector<uint32_t, 2> v;
+  const auto numAllocations = g_numAllocations;
+  v.emplace_back(1u);
+  v.emplace_back(2u);
+  CHECK(v.isInline());
+  CHECK(g_numAllocations == numAllocations);
+
+  v.emplace_back(3u); // Spills to the heap.
+  CHECK_FALSE(v.isInline());
+  REQUIRE(v.size() == 3);
+  CHECK((v[0] == 1 && v[1] == 2 && v[2] == 3));
+
+  v.clear();
+  CHECK(v.empty());
+  CHECK(v.capacity() == 4);
+
+  auto moved = std::move(v);
+  CHECK(v.capacity() == 2);
+  moved.emplace_back(4u);
+  CHECK((moved.size() == 1 && moved[0] == 4));
+}
+
+TEST_CASE_METHOD(Fixture, "Parallel execution", "[FrameGraph]") {
+  constexpr auto kNumWorkers = 4u;
+  FrameGraphThreadPool threadPool{kNumWorkers};
+  REQUIRE(threadPool.getNumWorkers() == kNumWorkers);
+
+  std::array<uint32_t, kNumWorkers> contexts{};
+  std::array<void *, kNumWorkers> contextPtrs{};
+  for (auto i = 0u; i < kNumWorkers; ++i)
+    contextPtrs[i] = &contexts[i];
+
+  struct PassData {
+    std::vector<FrameGraphResource> resources;
+    mutable int32_t order{-1};
+    mutable bool valid{true};
+  };
+  std::atomic<int32_t> counter{0};
+  const auto exec = [&counter](const PassData &data,
+                               FrameGraphPassResources &resources,
+                               void *context) {
+    for (const auto id : data.resources)
+      data.valid &= resources.get<FrameGraphBuffer>(id).alive;
+    const auto workerIndex = resources.getWorkerIndex();
+    data.valid &= workerIndex < kNumWorkers;
+    data.valid &= *static_cast<uint32_t *>(context) == 0;
+    data.order = counter++;
+  };
+
+  FrameGraph fg;
+  for (auto frame = 0; frame < 20; ++frame) {
+    counter = 0;
+    constexpr auto kWidth = 8;
+
+    auto &producer = fg.addCallbackPass<PassData>(
+      "Producer",
+      [](FrameGraph::Builder &builder, PassData &data) {
+        for (auto i = 0; i < kWidth; ++i) {
+          data.resources.emplace_back(
+            builder.write(builder.create<FrameGraphBuffer>("Buffer", {})));
+        }
+      },
+      exec);
+    std::vector<const PassData *> fanOut;
+    for (auto i = 0; i < kWidth; ++i) {
+      fanOut.emplace_back(&fg.addCallbackPass<PassData>(
+        "FanOut",
+        [&producer, i](FrameGraph::Builder &builder, PassData &data) {
+          data.resources.emplace_back(builder.read(producer.resources[i]));
+          data.resources.emplace_back(
+            builder.write(builder.create<FrameGraphBuffer>("Output", {})));
+        },
+        exec));
+    }
+    auto &consumer = fg.addCallbackPass<PassData>(
+      "Consumer",
+      [&fanOut](FrameGraph::Builder &builder, PassData &data) {
+        for (const auto *pass : fanOut)
+          data.resources.emplace_back(builder.read(pass->resources.back()));
+        builder.setSideEffect();
+      },
+      exec);
+
+    fg.compile();
+    fg.execute(threadPool, contextPtrs.data());
+
+    CHECK(FrameGraphBuffer::numAlive == 0);
+    CHECK(producer.order == 0);
+    CHECK(producer.valid);
+    for (const auto *pass : fanOut) {
+      CHECK(pass->valid);
+      CHECK(pass->order > producer.order);
+      CHECK(pass->order < consumer.order);
+    }
+    CHECK(consumer.valid);
+    CHECK(consumer.order == kWidth + 1);
+
+    fg.reset();
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Transient aliasing", "[FrameGraph]") {
+  constexpr uint64_t kSize{1000};
+  FrameGraph fg;
+
+  // Each pass reads the buffer of its predecessor, only 2 buffers are alive at
+  // the same time.
+  struct PassData {
+    FrameGraphResource buffer;
+    mutable uint64_t offset{0};
+  };
+  std::vector<const PassData *> passes;
+  for (auto i = 0; i < 4; ++i) {
+    passes.emplace_back(&fg.addCallbackPass<PassData>(
+      "Pass",
+      [&passes, i](FrameGraph::Builder &builder, PassData &data) {
+        if (i > 0) builder.read(passes.back()->buffer);
+        data.buffer = builder.create<FrameGraphHeapBuffer>("Buffer", {kSize});
+        data.buffer = builder.write(data.buffer);
+        if (i == 3) builder.setSideEffect();
+      },
+      [](const PassData &data, FrameGraphPassResources &resources, void *) {
+        data.offset = resources.get<FrameGraphHeapBuffer>(data.buffer).offset;
+      }));
+  }
+  fg.compile();
+
+  const auto &stats = fg.getTransientMemoryStats();
+  CHECK(stats.unaliasedSize == 4 * kSize);
+  CHECK(stats.peakLiveSize == 2 * kSize);
+  CHECK(stats.heapSize == 1024 + kSize); // Second buffer is aligned.
+
+  fg.execute();
+  for (const auto *pass : passes)
+    CHECK(pass->offset % 256 == 0);
+  CHECK(passes[0]->offset != passes[1]->offset);
+  CHECK(passes[0]->offset == passes[2]->offset);
+  CHECK(passes[1]->offset == passes[3]->offset);
+  fg.reset();
+
+  // Other reuses the buffer of Producer, so it has to wait for Consumer (the
+  // last reader) in the parallel execute(), even though it doesn't read it.
+  FrameGraphThreadPool threadPool{4};
+  struct Data {
+    FrameGraphResource buffer{-1};
+    mutable uint64_t offset{0};
+    mutable int32_t order{-1};
+  };
+  std::atomic<int32_t> counter{0};
+  const auto addPass = [&fg, &counter](const std::string_view name,
+                                       std::vector<FrameGraphResource> inputs,
+                                       bool final = false) -> const Data & {
+    return fg.addCallbackPass<Data>(
+      name,
+      [&](FrameGraph::Builder &builder, Data &data) {
+        for (const auto id : inputs)
+          builder.read(id);
+        if (final) {
+          builder.setSideEffect();
+        } else {
+          data.buffer = builder.write(
+            builder.create<FrameGraphHeapBuffer>("Buffer", {kSize}));
+        }
+      },
+      [&counter](const Data &data, FrameGraphPassResources &resources,
+                 void *) {
+        if (data.buffer >= 0) {
+          data.offset =
+            resources.get<FrameGraphHeapBuffer>(data.buffer).offset;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+        data.order = counter++;
+      });
+  };
+  for (auto frame = 0; frame < 10; ++frame) {
+    counter = 0;
+    const auto &producer = addPass("Producer", {});
+    const auto &consumer = addPass("Consumer", {producer.buffer});
+    const auto &other = addPass("Other", {});
+    addPass("Final", {consumer.buffer, other.buffer}, true);
+    fg.compile();
+    fg.execute(threadPool);
+
+    REQUIRE(other.offset == producer.offset);
+    CHECK(other.order > consumer.order);
+    fg.reset();
+  }
+
+  // Scratch only creates its buffer (nothing else accesses it), Other has to
+  // wait for it all the same.
+  for (auto frame = 0; frame < 10; ++frame) {
+    counter = 0;
+    const auto &scratch = fg.addCallbackPass<Data>(
+      "Scratch",
+      [](FrameGraph::Builder &builder, Data &data) {
+        data.buffer = builder.create<FrameGraphHeapBuffer>("Buffer", {kSize});
+        builder.setSideEffect();
+      },
+      [&counter](const Data &data, FrameGraphPassResources &resources,
+                 void *) {
+        data.offset = resources.get<FrameGraphHeapBuffer>(data.buffer).offset;
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+        data.order = counter++;
+      });
+    const auto &other = addPass("Other", {});
+    addPass("Final", {other.buffer}, true);
+    fg.compile();
+    fg.execute(threadPool);
+
+    REQUIRE(other.offset == scratch.offset);
+    CHECK(other.order > scratch.order);
+    fg.reset();
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Scheduling", "[FrameGraph]") {
+  constexpr uint64_t kSize{1000};
+
+  // Two independent chains: A (A1 -> A2) and B (B1 -> B2).
+  const auto compile = [](FrameGraph &fg, bool interleaved,
+                          FrameGraph::Schedule schedule) {
+    struct PassData {
+      FrameGraphResource buffer;
+    };
+    const auto addProducer = [&fg] {
+      return fg
+        .addCallbackPass<PassData>(
+          "Producer",
+          [](FrameGraph::Builder &builder, PassData &data) {
+            data.buffer =
+              builder.create<FrameGraphHeapBuffer>("Buffer", {kSize});
+            data.buffer = builder.write(data.buffer);
+          },
+          [](const PassData &, FrameGraphPassResources &, void *) {})
+        .buffer;
+    };
+    const auto addConsumer = [&fg](FrameGraphResource buffer) {
+      fg.addCallbackPass(
+        "Consumer",
+        [buffer](FrameGraph::Builder &builder, auto &) {
+          builder.read(buffer);
+          builder.setSideEffect();
+        },
+        [](const auto &, FrameGraphPassResources &, void *) {});
+    };
+    if (interleaved) {
+      // A1, B1, A2, B2
+      const auto a = addProducer();
+      const auto b = addProducer();
+      addConsumer(a);
+      addConsumer(b);
+    } else {
+      // A1, A2, B1, B2
+      addConsumer(addProducer());
+      addConsumer(addProducer());
+    }
+    fg.setSchedule(schedule);
+    fg.compile();
+  };
+
+  SECTION("Declaration order") {
+    FrameGraph fg;
+    compile(fg, true, FrameGraph::Schedule::DeclarationOrder);
+    CHECK(fg.getExecutionOrder() == std::vector<uint32_t>{0, 1, 2, 3});
+    CHECK(fg.getTransientMemoryStats().peakLiveSize == 2 * kSize);
+  }
+  SECTION("Minimize memory") {
+    FrameGraph fg;
+    compile(fg, true, FrameGraph::Schedule::MinimizeMemory);
+    CHECK(fg.getExecutionOrder() == std::vector<uint32_t>{0, 2, 1, 3});
+    CHECK(fg.getTransientMemoryStats().peakLiveSize == kSize);
+    CHECK(fg.getTransientMemoryStats().heapSize == kSize);
+    fg.execute();
+  }
+  SECTION("Maximize distance") {
+    FrameGraph fg;
+    compile(fg, false, FrameGraph::Schedule::MaximizeDistance);
+    CHECK(fg.getExecutionOrder() == std::vector<uint32_t>{0, 2, 1, 3});
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Pass merging", "[FrameGraph]") {
+  enum Flags : uint32_t { Attachment = 1, InputAttachment, Sampled };
+
+  FrameGraph fg;
+  fg.setPassMerging([](const FrameGraph::Transition &write,
+                       const FrameGraph::Transition &read) {
+    return write.flags == Attachment && read.flags == InputAttachment;
+  });
+
+  struct PassData {
+    FrameGraphResource target;
+    mutable uint32_t subpassIndex{~0u};
+    mutable uint32_t numSubpasses{0};
+    mutable uint32_t workerIndex{~0u};
+  };
+  const auto exec = [](const PassData &data,
+                       FrameGraphPassResources &resources, void *) {
+    data.subpassIndex = resources.getSubpassIndex();
+    data.numSubpasses = resources.getNumSubpasses();
+    data.workerIndex = resources.getWorkerIndex();
+  };
+  auto &gbuffer = fg.addCallbackPass<PassData>(
+    "GBuffer",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.target = builder.create<FrameGraphTexture>("Albedo", {});
+      data.target = builder.write(data.target, Attachment);
+    },
+    exec);
+  auto &lighting = fg.addCallbackPass<PassData>(
+    "Lighting",
+    [&gbuffer](FrameGraph::Builder &builder, PassData &data) {
+      builder.read(gbuffer.target, InputAttachment);
+      data.target = builder.create<FrameGraphTexture>("HDR", {});
+      data.target = builder.write(data.target, Attachment);
+    },
+    exec);
+  auto &tonemap = fg.addCallbackPass<PassData>(
+    "Tonemap",
+    [&lighting](FrameGraph::Builder &builder, PassData &) {
+      builder.read(lighting.target, Sampled);
+      builder.setSideEffect();
+    },
+    exec);
+  fg.compile();
+
+  REQUIRE(fg.getMergeGroups().size() == 1);
+  CHECK(fg.getMergeGroups()[0].first == 0);
+  CHECK(fg.getMergeGroups()[0].count == 2);
+
+  const auto check = [&] {
+    CHECK(gbuffer.subpassIndex == 0);
+    CHECK(gbuffer.numSubpasses == 2);
+    CHECK(lighting.subpassIndex == 1);
+    CHECK(lighting.numSubpasses == 2);
+    CHECK(tonemap.subpassIndex == 0);
+    CHECK(tonemap.numSubpasses == 1);
+  };
+  fg.execute();
+  check();
+
+  FrameGraphThreadPool threadPool{4};
+  fg.execute(threadPool);
+  check();
+  CHECK(gbuffer.workerIndex == lighting.workerIndex);
+}
+
+TEST_CASE_METHOD(Fixture, "Queues", "[FrameGraph]") {
+  FrameGraph fg;
+  FrameGraphCpuQueues queues;
+
+  // Commands of passes compute values of resources (on queue threads).
+  std::array<int32_t, 5> values{};
+  auto *v = values.data();
+  struct PassData {
+    FrameGraphResource output;
+  };
+  const auto addPass = [&fg](const std::string_view name,
+                             FrameGraphQueue queue,
+                             std::vector<FrameGraphResource> inputs,
+                             std::function<void()> command) {
+    return fg
+      .addCallbackPass<PassData>(
+        name,
+        [&](FrameGraph::Builder &builder, PassData &data) {
+          builder.setQueue(queue);
+          for (const auto id : inputs)
+            builder.read(id);
+          data.output = builder.write(
+            builder.create<FrameGraphBuffer>(name, {}));
+          if (inputs.size() > 1) builder.setSideEffect();
+        },
+        [command](const PassData &, FrameGraphPassResources &, void *ctx) {
+          static_cast<FrameGraphCpuQueues::CommandList *>(ctx)->record(
+            command);
+        })
+      .output;
+  };
+
+  for (auto frame = 0; frame < 3; ++frame) {
+    values = {};
+    const auto depth =
+      addPass("Depth", FrameGraphQueue::Graphics, {}, [v] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        v[0] = 1;
+      });
+    const auto ao = addPass("SSAO", FrameGraphQueue::Compute, {depth},
+                            [v] { v[1] = v[0] + 1; });
+    const auto lights = addPass("Light culling", FrameGraphQueue::Compute,
+                                {depth}, [v] { v[2] = v[0] + 10; });
+    const auto shadows =
+      addPass("Shadows", FrameGraphQueue::Graphics, {}, [] {});
+    addPass("Lighting", FrameGraphQueue::Graphics, {shadows, ao, lights},
+            [v] { v[3] = v[1] + v[2]; });
+    addPass("Readback", FrameGraphQueue::Transfer, {ao, depth},
+            [v] { v[4] = v[1] * 100 + v[0]; });
+    fg.compile();
+
+    using Stream = std::vector<uint32_t>;
+    CHECK(fg.getQueueStream(FrameGraphQueue::Graphics) == Stream{0, 3, 4});
+    CHECK(fg.getQueueStream(FrameGraphQueue::Compute) == Stream{1, 2});
+    CHECK(fg.getQueueStream(FrameGraphQueue::Transfer) == Stream{5});
+
+    // Light culling is covered by the wait of SSAO, Lighting waits only for
+    // the last compute pass, Readback for SSAO (that has waited for Depth).
+    const auto &syncPoints = fg.getSyncPoints();
+    REQUIRE(syncPoints.size() == 3);
+    const auto check = [](const FrameGraph::SyncPoint &syncPoint,
+                          uint32_t signalPassId, uint32_t waitPassId,
+                          uint32_t value) {
+      CHECK(syncPoint.signalPassId == signalPassId);
+      CHECK(syncPoint.waitPassId == waitPassId);
+      CHECK(syncPoint.value == value);
+    };
+    check(syncPoints[0], 0, 1, 1);
+    check(syncPoints[1], 2, 4, 2);
+    check(syncPoints[2], 1, 5, 1);
+
+    fg.execute(queues);
+    queues.submit();
+    CHECK(queues.getNumWaits() == 3);
+    CHECK(values == std::array{1, 2, 11, 13, 201});
+    CHECK(FrameGraphBuffer::numAlive == 0);
+
+    fg.reset();
+  }
+
+  SECTION("Aliasing") {
+    constexpr uint64_t kSize{1024};
+    // A buffer of Producer (last read by Consumer) can be reused by Other
+    // only if Other waits for Consumer.
+    for (const auto queue :
+         {FrameGraphQueue::Graphics, FrameGraphQueue::Compute}) {
+      struct Data {
+        FrameGraphResource buffer;
+      };
+      const auto addPass = [&fg](const std::string_view name,
+                                 FrameGraphQueue queue,
+                                 std::vector<FrameGraphResource> inputs) {
+        return fg
+          .addCallbackPass<Data>(
+            name,
+            [&](FrameGraph::Builder &builder, Data &data) {
+              builder.setQueue(queue);
+              for (const auto id : inputs)
+                builder.read(id);
+              if (inputs.size() > 1) {
+                builder.setSideEffect();
+              } else {
+                data.buffer = builder.write(
+                  builder.create<FrameGraphHeapBuffer>("Buffer", {kSize}));
+              }
+            },
+            [](const Data &, FrameGraphPassResources &, void *) {})
+          .buffer;
+      };
+      const auto producer = addPass("Producer", FrameGraphQueue::Graphics, {});
+      const auto consumer = addPass("Consumer", queue, {producer});
+      const auto other = addPass("Other", FrameGraphQueue::Graphics, {});
+      addPass("Final", FrameGraphQueue::Graphics, {consumer, other});
+      fg.compile();
+
+      const auto numBuffers = queue == FrameGraphQueue::Graphics ? 2 : 3;
+      CHECK(fg.getTransientMemoryStats().heapSize == numBuffers * kSize);
+      fg.reset();
+    }
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Resource pool", "[FrameGraph]") {
+  FrameGraphResourcePool pool{2};
+  FrameGraph fg;
+  fg.setResourcePool(&pool);
+
+  struct PassData {
+    FrameGraphResource texture;
+    mutable int32_t id{-1};
+  };
+  const auto frame = [&fg, &pool](uint32_t width) {
+    auto &pass1 = fg.addCallbackPass<PassData>(
+      "Pass1",
+      [width](FrameGraph::Builder &builder, PassData &data) {
+        data.texture =
+          builder.create<FrameGraphPooledTexture>("Texture", {width, 128});
+        data.texture = builder.write(data.texture);
+      },
+      [](const PassData &data, FrameGraphPassResources &resources, void *) {
+        data.id = resources.get<FrameGraphPooledTexture>(data.texture).id;
+      });
+    fg.addCallbackPass(
+      "Pass2",
+      [&pass1](FrameGraph::Builder &builder, auto &) {
+        builder.read(pass1.texture);
+        // Created every frame, the pool doesn't see it.
+        std::ignore = builder.write(
+          builder.create<FrameGraphUnpooledTexture>("Unpooled", {1, 1}));
+        builder.setSideEffect();
+      },
+      [](const auto &, FrameGraphPassResources &, void *) {});
+    fg.compile();
+    fg.execute();
+    fg.reset();
+    pool.update(nullptr);
+    return pass1.id;
+  };
+
+  const auto &stats = pool.getStats();
+
+  const auto id = frame(128);
+  CHECK(stats.numMisses == 1);
+  CHECK(stats.numPooled == 1);
+  CHECK(frame(128) == id); // Recycled.
+  CHECK(stats.numHits == 1);
+
+  CHECK(frame(256) != id); // Different descriptor.
+  CHECK(stats.numMisses == 2);
+  CHECK(stats.numPooled == 2);
+  CHECK(FrameGraphPooledTexture::numDestroyed == 0);
+
+  // Unused for more than 2 frames.
+  frame(256);
+  frame(256);
+  CHECK(stats.numEvictions == 1);
+  CHECK(stats.numPooled == 1);
+  CHECK(FrameGraphPooledTexture::numDestroyed == 1);
+
+  pool.clear(nullptr);
+  CHECK(FrameGraphPooledTexture::numDestroyed == 2);
+  CHECK(FrameGraphPooledTexture::numCreated == 2);
+}
+
+TEST_CASE_METHOD(Fixture, "Batched barriers", "[FrameGraph]") {
+  FrameGraph fg;
+
+  struct Batch {
+    uint32_t numReads{0};
+    uint32_t numWrites{0};
+  };
+  static std::vector<Batch> batches;
+  batches.clear();
+  fg.setBarrierHandler([](const FrameGraph::Transition *transitions,
+                          uint32_t count, void *) {
+    auto &batch = batches.emplace_back();
+    for (auto i = 0u; i < count; ++i) {
+      const auto &transition = transitions[i];
+      CHECK(transition.entry->isTransient());
+      if (transition.access == FrameGraph::Transition::Access::Read) {
+        CHECK(transition.flags == 1);
+        ++batch.numReads;
+      } else {
+        CHECK(transition.flags == 2);
+        ++batch.numWrites;
+      }
+    }
+  });
+
+  struct PassData {
+    FrameGraphResource a;
+    FrameGraphResource b;
+  };
+  auto &pass1 = fg.addCallbackPass<PassData>(
+    "Pass1",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.a = builder.write(builder.create<FrameGraphTexture>("A", {}), 2);
+      data.b = builder.write(builder.create<FrameGraphTexture>("B", {}), 2);
+    },
+    [](const PassData &, FrameGraphPassResources &, void *) {});
+  fg.addCallbackPass(
+    "Pass2",
+    [&pass1](FrameGraph::Builder &builder, auto &) {
+      builder.read(pass1.a, 1);
+      builder.read(pass1.b, 1);
+      builder.read(pass1.b); // Ignored flags, no transition.
+      builder.setSideEffect();
+    },
+    [](const auto &, FrameGraphPassResources &, void *) {});
+  fg.compile();
+  fg.execute();
+
+  // One call per pass.
+  REQUIRE(batches.size() == 2);
+  CHECK(batches[0].numReads == 0);
+  CHECK(batches[0].numWrites == 2);
+  CHECK(batches[1].numReads == 2);
+  CHECK(batches[1].numWrites == 0);
+}
+
+TEST_CASE_METHOD(Fixture, "Transition elision", "[FrameGraph]") {
+  FrameGraph fg;
+  fg.setTransitionElision();
+
+  static std::atomic<uint32_t> numIssued;
+  numIssued = 0;
+  fg.setBarrierHandler(
+    [](const FrameGraph::Transition *, uint32_t count, void *) {
+      numIssued += count;
+    });
+
+  // 5 passes sample the same texture, in the same state.
+  struct PassData {
+    FrameGraphResource texture;
+  };
+  auto &gbuffer = fg.addCallbackPass<PassData>(
+    "GBuffer",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.texture = builder.create<FrameGraphTexture>("GBuffer", {});
+      data.texture = builder.write(data.texture, 1);
+    },
+    [](const PassData &, FrameGraphPassResources &, void *) {});
+  for (auto i = 0; i < 5; ++i) {
+    fg.addCallbackPass(
+      "Lighting",
+      [&gbuffer](FrameGraph::Builder &builder, auto &) {
+        builder.read(gbuffer.texture, 2);
+        builder.setSideEffect();
+      },
+      [](const auto &, FrameGraphPassResources &, void *) {});
+  }
+  fg.compile();
+
+  const auto &stats = fg.getTransitionStats();
+  CHECK(stats.numTransitions == 6);
+  CHECK(stats.numElided == 4);
+
+  fg.execute();
+  CHECK(numIssued == 2);
+
+  // Readers are not ordered, each one issues its own transition.
+  numIssued = 0;
+  FrameGraphThreadPool threadPool{2};
+  fg.execute(threadPool);
+  CHECK(numIssued == 6);
+
+  // A write with ignored flags leaves the texture in an unknown state, the
+  // next read can't be elided.
+  FrameGraph other;
+  other.setTransitionElision();
+  auto &producer = other.addCallbackPass<PassData>(
+    "Producer",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.texture = builder.create<FrameGraphTexture>("Texture", {});
+      data.texture = builder.write(data.texture, 1);
+    },
+    [](const PassData &, FrameGraphPassResources &, void *) {});
+  auto &overwrite = other.addCallbackPass<PassData>(
+    "Overwrite",
+    [&producer](FrameGraph::Builder &builder, PassData &data) {
+      builder.read(producer.texture, 2);
+      data.texture = builder.write(producer.texture);
+    },
+    [](const PassData &, FrameGraphPassResources &, void *) {});
+  other.addCallbackPass(
+    "Consumer",
+    [&overwrite](FrameGraph::Builder &builder, auto &) {
+      builder.read(overwrite.texture, 2);
+      builder.setSideEffect();
+    },
+    [](const auto &, FrameGraphPassResources &, void *) {});
+  other.compile();
+  CHECK(other.getTransitionStats().numTransitions == 3);
+  CHECK(other.getTransitionStats().numElided == 0);
+}
+
+TEST_CASE_METHOD(Fixture, "Split barriers", "[FrameGraph]") {
+  using Log = std::vector<std::string>;
+  struct FrameGraphSplitTexture {
+    struct Desc {};
+
+    void create(const Desc &, void *) {}
+    void destroy(const Desc &, void *) {}
+
+    void beginTransition(const Desc &, uint32_t previousFlags,
+                         uint32_t nextFlags, void *ctx) {
+      static_cast<Log *>(ctx)->emplace_back(
+        "begin " + std::to_string(int32_t(previousFlags)) + ">" +
+        std::to_string(nextFlags));
+    }
+    void endTransition(const Desc &, uint32_t previousFlags,
+                       uint32_t nextFlags, void *ctx) {
+      static_cast<Log *>(ctx)->emplace_back(
+        "end " + std::to_string(int32_t(previousFlags)) + ">" +
+        std::to_string(nextFlags));
+    }
+  };
+  static_assert(has_splitTransitions<FrameGraphSplitTexture>);
+  static_assert(!has_splitTransitions<FrameGraphTexture>);
+
+  FrameGraph fg;
+  struct PassData {
+    FrameGraphResource texture;
+  };
+  const auto log = [](const std::string_view name) {
+    return [name](const PassData &, FrameGraphPassResources &, void *ctx) {
+      static_cast<Log *>(ctx)->emplace_back(name);
+    };
+  };
+  auto &a = fg.addCallbackPass<PassData>(
+    "A",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.texture = builder.create<FrameGraphSplitTexture>("Texture", {});
+      data.texture = builder.write(data.texture, 1);
+    },
+    log("A"));
+  // Unrelated, the transition of the texture overlaps with it.
+  fg.addCallbackPass<PassData>(
+    "B",
+    [](FrameGraph::Builder &builder, PassData &) { builder.setSideEffect(); },
+    log("B"));
+  fg.addCallbackPass<PassData>(
+    "C",
+    [&a](FrameGraph::Builder &builder, PassData &) {
+      builder.read(a.texture, 2);
+      builder.setSideEffect();
+    },
+    log("C"));
+  // Not split across queues.
+  fg.addCallbackPass<PassData>(
+    "D",
+    [&a](FrameGraph::Builder &builder, PassData &) {
+      builder.read(a.texture, 3);
+      builder.setQueue(FrameGraphQueue::Compute).setSideEffect();
+    },
+    log("D"));
+  fg.compile();
+
+  const auto &stats = fg.getTransitionStats();
+  CHECK(stats.numTransitions == 3);
+  CHECK(stats.numSplit == 1);
+
+  Log executed;
+  fg.execute(&executed);
+  CHECK(executed == Log{
+                      "begin -1>1",
+                      "end -1>1",
+                      "A",
+                      "begin 1>2",
+                      "B",
+                      "end 1>2",
+                      "C",
+                      "begin 2>3",
+                      "end 2>3",
+                      "D",
+                    });
+
+  // Readers of the same version are not ordered by the parallel execute(),
+  // the transition between them is not split.
+  static std::mutex mutex;
+  static Log events;
+  struct FrameGraphSharedTexture {
+    struct Desc {};
+
+    void create(const Desc &, void *) {}
+    void destroy(const Desc &, void *) {}
+
+    void beginTransition(const Desc &, uint32_t, uint32_t nextFlags, void *) {
+      const std::lock_guard lock{mutex};
+      events.emplace_back("begin " + std::to_string(nextFlags));
+    }
+    void endTransition(const Desc &, uint32_t, uint32_t nextFlags, void *) {
+      const std::lock_guard lock{mutex};
+      events.emplace_back("end " + std::to_string(nextFlags));
+    }
+  };
+  FrameGraph shared;
+  auto &producer = shared.addCallbackPass<PassData>(
+    "Producer",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.texture = builder.create<FrameGraphSharedTexture>("Texture", {});
+      data.texture = builder.write(data.texture, 1);
+    },
+    [](const PassData &, FrameGraphPassResources &, void *) {});
+  for (auto flags : {2u, 3u}) {
+    shared.addCallbackPass<PassData>(
+      "Reader",
+      [&producer, flags](FrameGraph::Builder &builder, PassData &) {
+        builder.read(producer.texture, flags);
+        builder.setSideEffect();
+      },
+      [](const PassData &, FrameGraphPassResources &, void *) {
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+      });
+  }
+  shared.compile();
+  CHECK(shared.getTransitionStats().numSplit == 1);
+
+  FrameGraphThreadPool threadPool{4};
+  for (auto i = 0; i < 50; ++i) {
+    events.clear();
+    shared.execute(threadPool);
+    REQUIRE(events.size() == 6);
+    for (const auto flags : {"1", "2", "3"}) {
+      const auto begin = std::find(events.cbegin(), events.cend(),
+                                   std::string{"begin "} + flags);
+      const auto end = std::find(events.cbegin(), events.cend(),
+                                 std::string{"end "} + flags);
+      CHECK(begin < end);
+    }
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Recorders", "[FrameGraph]") {
+  using Log = std::vector<std::string>;
+  FrameGraph fg;
+  struct PassData {
+    FrameGraphResource texture;
+  };
+  const auto log = [](const std::string_view name) {
+    return [name](const PassData &data, FrameGraphPassResources &resources,
+                  void *ctx) {
+      CHECK(resources.get<FrameGraphTexture>(data.texture).id != -1);
+      static_cast<Log *>(ctx)->emplace_back(name);
+    };
+  };
+
+  for (auto frame = 0; frame < 2; ++frame) {
+    const auto depth =
+      fg.import<FrameGraphTexture>("Depth", {1, 1}, FrameGraphTexture{7});
+    // Merged in this order, regardless of the threads.
+    auto &shadows = fg.createRecorder();
+    auto &reflections = fg.createRecorder();
+
+    const PassData *shadowMap{nullptr};
+    std::thread shadowsThread{[&shadows, &shadowMap, &log] {
+      shadows.addCallbackPass<PassData>(
+        "Culled",
+        [](FrameGraph::Builder &builder, PassData &data) {
+          data.texture = builder.create<FrameGraphTexture>("Unused", {1, 1});
+          data.texture = builder.write(data.texture);
+        },
+        log("Culled"));
+      shadowMap = &shadows.addCallbackPass<PassData>(
+        "Shadows",
+        [](FrameGraph::Builder &builder, PassData &data) {
+          data.texture =
+            builder.create<FrameGraphTexture>("ShadowMap", {4, 4});
+          data.texture = builder.write(data.texture);
+        },
+        log("Shadows"));
+    }};
+    const PassData *reflection{nullptr};
+    std::thread reflectionsThread{[&reflections, &reflection, depth, &log] {
+      reflection = &reflections.addCallbackPass<PassData>(
+        "Reflections",
+        [depth](FrameGraph::Builder &builder, PassData &data) {
+          // A resource of the main graph.
+          builder.read(depth);
+          data.texture =
+            builder.create<FrameGraphTexture>("Reflection", {2, 2});
+          data.texture = builder.write(data.texture);
+        },
+        log("Reflections"));
+      CHECK(reflections.getDescriptor<FrameGraphTexture>(depth).width == 1);
+    }};
+    shadowsThread.join();
+    reflectionsThread.join();
+
+    // Handles of recorders, in the main graph.
+    fg.mergeRecorders();
+    CHECK(fg.getDescriptor<FrameGraphTexture>(shadowMap->texture).width == 4);
+    fg.addCallbackPass<PassData>(
+      "Main",
+      [&](FrameGraph::Builder &builder, PassData &data) {
+        builder.read(shadowMap->texture);
+        data.texture = builder.read(reflection->texture);
+        builder.setSideEffect();
+      },
+      log("Main"));
+    fg.compile();
+
+    Log executed;
+    fg.execute(&executed);
+    CHECK(executed == Log{"Shadows", "Reflections", "Main"});
+    // The last frame is destroyed along with the graph.
+    if (frame == 0) fg.reset();
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Static pipeline", "[FrameGraph]") {
+  using Log = std::vector<std::string>;
+  using Depth = FrameGraphStaticTransient<struct DepthTag, FrameGraphTexture>;
+  using Color = FrameGraphStaticTransient<struct ColorTag, FrameGraphTexture>;
+  using Unused = FrameGraphStaticTransient<struct UnusedTag, FrameGraphTexture>;
+  using Backbuffer =
+    FrameGraphStaticImported<struct BackbufferTag, FrameGraphTexture>;
+
+  struct DepthPass {
+    using Reads = std::tuple<>;
+    using Writes = std::tuple<Depth>;
+
+    void operator()(FrameGraphTexture &depth, void *ctx) const {
+      CHECK(depth.id == 1);
+      static_cast<Log *>(ctx)->emplace_back("Depth");
+    }
+  };
+  struct UnusedPass {
+    using Reads = std::tuple<Depth>;
+    using Writes = std::tuple<Unused>;
+
+    void operator()(const FrameGraphTexture &, FrameGraphTexture &,
+                    void *) const {
+      CHECK(false);
+    }
+  };
+  struct ColorPass {
+    using Reads = std::tuple<FrameGraphStaticAccess<Depth, 1>>;
+    using Writes = std::tuple<Color>;
+
+    void operator()(const FrameGraphTexture &depth, FrameGraphTexture &color,
+                    void *ctx) const {
+      CHECK(depth.id == 1);
+      CHECK(color.id == 2);
+      static_cast<Log *>(ctx)->emplace_back("Color");
+    }
+  };
+  // Writes to an imported resource, not culled.
+  struct PresentPass {
+    using Reads = std::tuple<Color>;
+    using Writes = std::tuple<Backbuffer>;
+
+    void operator()(const FrameGraphTexture &, FrameGraphTexture &backbuffer,
+                    void *ctx) const {
+      CHECK(backbuffer.id == 7);
+      static_cast<Log *>(ctx)->emplace_back("Present");
+    }
+  };
+
+  using Pipeline =
+    FrameGraphStaticPipeline<DepthPass, UnusedPass, ColorPass, PresentPass>;
+  static_assert(Pipeline::kNumResources == 4);
+  constexpr auto &order = Pipeline::getExecutionOrder();
+  static_assert(order.size() == 3 && order[0] == 0 && order[1] == 2 &&
+                order[2] == 3);
+  static_assert(Pipeline::isCulled<UnusedPass>());
+
+  Pipeline pipeline;
+  pipeline.setDescriptor<Depth>({4, 4});
+  CHECK(pipeline.getDescriptor<Depth>().width == 4);
+  pipeline.import<Backbuffer>({4, 4}, FrameGraphTexture{7});
+
+  Log executed;
+  pipeline.execute(&executed);
+  CHECK(executed == Log{"Depth", "Color", "Present"});
+  CHECK(pipeline.get<Backbuffer>().id == 7);
+  CHECK(pipeline.get<Unused>().id == -1);
+}
+
+#ifdef FG_ENABLE_INSTRUMENTATION
+TEST_CASE_METHOD(Fixture, "Trace recorder", "[FrameGraph]") {
+  FrameGraphTraceRecorder recorder;
+  FrameGraph fg;
+  fg.setInstrumentation(&recorder);
+
+  struct PassData {
+    FrameGraphResource texture;
+  };
+  auto &pass1 = fg.addCallbackPass<PassData>(
+    "Pass \"1\"",
+    [](FrameGraph::Builder &builder, PassData &data) {
+      data.texture = builder.create<FrameGraphTexture>("Texture", {});
+      data.texture = builder.write(data.texture);
+    },
+    [](const PassData &, FrameGraphPassResources &, void *) {});
+  fg.addCallbackPass(
+    "Pass2",
+    [&pass1](FrameGraph::Builder &builder, auto &) {
+      builder.read(pass1.texture, 1);
+      builder.setSideEffect();
+    },
+    [](const auto &, FrameGraphPassResources &, void *) {});
+  fg.compile();
+  fg.execute();
+
+  // Pass1: Pass, Create, Execute. Pass2: Pass, Barriers, Execute, Destroy.
+  CHECK(recorder.getNumEvents() == 2 * (3 + 4));
+
+  std::ostringstream os;
+  recorder.write(os);
+  const auto json = os.str();
+  CHECK(json.find(R"("name":"Pass \"1\"")") != std::string::npos);
+  CHECK(json.find(R"("name":"Barriers","cat":"Phase","ph":"B")") !=
+        std::string::npos);
+
+  recorder.clear();
+  CHECK(recorder.getNumEvents() == 0);
+
+  // Per worker of the parallel execute(), names outlive the graph.
+  FrameGraphThreadPool threadPool{2};
+  FrameGraphTraceRecorder parallelRecorder{threadPool.getNumWorkers()};
+  {
+    FrameGraph other;
+    other.setInstrumentation(&parallelRecorder);
+    for (auto i = 0; i < 4; ++i) {
+      other.addCallbackPass(
+        "Side-effect", [](FrameGraph::Builder &builder, auto &) {
+          builder.setSideEffect();
+        },
+        [](const auto &, FrameGraphPassResources &, void *) {});
+    }
+    other.compile();
+    other.execute(threadPool);
+  }
+  // Pass, Execute, Destroy.
+  CHECK(parallelRecorder.getNumEvents() == 4 * (2 + 2 + 2));
+  os.str({});
+  parallelRecorder.write(os);
+  CHECK(os.str().find(R"("name":"Side-effect","cat":"Pass")") !=
+        std::string::npos);
+}
+#endif
+
 TEST_CASE_METHOD(Fixture, "Basic operations", "[Blackboard]") {
   FrameGraphBlackboard bb;
 
@@ -309,5 +1666,55 @@ TEST_CASE_METHOD(Fixture, "Copy", "[Blackboard]") {
 
   CHECK(copy.get<Data>().value != data.value);
 }
+TEST_CASE_METHOD(Fixture, "Clear", "[Blackboard]") {
+  FrameGraphBlackboard bb;
+  struct Data {
+    std::shared_ptr<int32_t> value;
+  };
+  auto value = std::make_shared<int32_t>(42);
+  const auto frame = [&bb, &value] {
+    bb.add<Data>(value);
+    CHECK(*bb.get<Data>().value == 42);
+    bb.clear();
+    CHECK_FALSE(bb.has<Data>());
+  };
+
+  frame();
+  CHECK(value.use_count() == 1); // Destroyed by clear().
+  const auto numAllocations = g_numAllocations;
+  frame();
+  CHECK(g_numAllocations == numAllocations);
+}
+TEST_CASE_METHOD(Fixture, "Move", "[Blackboard]") {
+  FrameGraphBlackboard bb;
+  struct Small {
+    int32_t value{0};
+  };
+  struct Large {
+    std::array<std::byte, 2048> bytes; // Larger than a block of the arena.
+  };
+  bb.add<Small>(1);
+  bb.add<Large>();
+
+  FrameGraphBlackboard moved{std::move(bb)};
+  CHECK(moved.get<Small>().value == 1);
+  CHECK(moved.has<Large>());
+
+  // The moved-from one is empty, and reusable.
+  for (auto frame = 0; frame < 2; ++frame) {
+    CHECK_FALSE(bb.has<Small>());
+    bb.add<Small>(2);
+    bb.add<Large>();
+    CHECK(bb.get<Small>().value == 2);
+    bb.clear();
+  }
+
+  bb = std::move(moved);
+  CHECK(bb.get<Small>().value == 1);
+  CHECK_FALSE(moved.has<Small>());
+  moved.add<Small>(3);
+  CHECK(moved.get<Small>().value == 3);
+  moved.clear();
+}
 
 int main(int argc, char *argv[]) { return Catch::Session().run(argc, argv); }